@@ -8,17 +8,32 @@ SOURCES += \
     common/entities/datastruct.cpp \
     common/entities/txtrecord.cpp \
     common/entities/service.cpp \
+    common/entities/receivesession.cpp \
+    common/entities/rangesender.cpp \
+    common/entities/devicerecord.cpp \
     common/entities/historyelement.cpp \
+    common/entities/historystore.cpp \
     common/threads/servicethread.cpp \
     common/threads/clipboardthreadevent.cpp \
     common/threads/devicethread.cpp \
+    common/threads/devicepool.cpp \
+    common/threads/historycompactionthread.cpp \
+    common/threads/logthread.cpp \
     common/threads/deviceconnectionthreadevent.cpp \
     common/threads/devicepingthreadevent.cpp \
     common/threads/devicepongthreadevent.cpp \
     common/threads/devicecanceltransfertthreadevent.cpp \
     common/helpers/filehelper.cpp \
     common/helpers/logmanager.cpp \
-    common/helpers/folderzipper.cpp \
+    common/helpers/logbuffer.cpp \
+    common/helpers/tracemanager.cpp \
+    common/helpers/metricsmanager.cpp \
+    common/helpers/metricsserver.cpp \
+    common/helpers/folderextractor.cpp \
+    common/helpers/folderstreamer.cpp \
+    common/helpers/chunksizer.cpp \
+    common/helpers/sendpump.cpp \
+    common/helpers/resumejournal.cpp \
     common/helpers/settingsmanager.cpp \
     common/helpers/servicehelper.cpp \
     common/helpers/fonthelper.cpp \
@@ -35,10 +50,11 @@ SOURCES += \
     common/view/utils/progressindicator.cpp \
     common/view/view.cpp \
     common/view/configpanel/configpanel.cpp \
-    common/view/configpanel/historyelementview.cpp \
     common/view/configpanel/transparentscrollbar.cpp \
     common/view/configpanel/transparentscrollbutton.cpp \
     common/view/configpanel/historylistwidget.cpp \
+    common/view/configpanel/historymodel.cpp \
+    common/view/configpanel/historydelegate.cpp \
     common/view/devicespanel/slidingstackedwidget.cpp \
     common/view/devicespanel/howtopanel.cpp
 
@@ -52,17 +68,32 @@ HEADERS += \
     common/entities/datastruct.h \
     common/entities/txtrecord.h \
     common/entities/service.h \
+    common/entities/receivesession.h \
+    common/entities/rangesender.h \
+    common/entities/devicerecord.h \
     common/entities/historyelement.h \
+    common/entities/historystore.h \
     common/threads/servicethread.h \
     common/threads/clipboardthreadevent.h \
     common/threads/devicethread.h \
+    common/threads/devicepool.h \
+    common/threads/historycompactionthread.h \
+    common/threads/logthread.h \
     common/threads/deviceconnectionthreadevent.h \
     common/threads/devicepingthreadevent.h \
     common/threads/devicepongthreadevent.h \
     common/threads/devicecanceltransfertthreadevent.h \
     common/helpers/filehelper.h \
     common/helpers/logmanager.h \
-    common/helpers/folderzipper.h \
+    common/helpers/logbuffer.h \
+    common/helpers/tracemanager.h \
+    common/helpers/metricsmanager.h \
+    common/helpers/metricsserver.h \
+    common/helpers/folderextractor.h \
+    common/helpers/folderstreamer.h \
+    common/helpers/chunksizer.h \
+    common/helpers/sendpump.h \
+    common/helpers/resumejournal.h \
     common/helpers/settingsmanager.h \
     common/helpers/fonthelper.h \
     common/helpers/servicehelper.h \
@@ -79,10 +110,11 @@ HEADERS += \
     common/view/utils/progressindicator.h \
     common/view/view.h \
     common/view/configpanel/configpanel.h \
-    common/view/configpanel/historyelementview.h \
     common/view/configpanel/transparentscrollbar.h \
     common/view/configpanel/transparentscrollbutton.h \
     common/view/configpanel/historylistwidget.h \
+    common/view/configpanel/historymodel.h \
+    common/view/configpanel/historydelegate.h \
     common/view/devicespanel/slidingstackedwidget.h \
     common/view/devicespanel/howtopanel.h
 
@@ -93,7 +125,6 @@ FORMS += \
     common/view/widgets/smalldeviceview.ui \
     common/view/dialogs/updatedialog.ui \
     common/view/view.ui \
-    common/view/configpanel/historyelementview.ui \
     common/view/configpanel/configpanel.ui \
     common/view/devicespanel/settingswidget.ui \
     common/view/devicespanel/aboutwidget.ui \
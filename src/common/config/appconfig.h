@@ -26,7 +26,7 @@
 
 #define CURRENT_VERSION "2.0.0"
 #define PROTOCOL_VERSION "2"
-#define APP_HISTORY_VERSION 2
+#define APP_HISTORY_VERSION 3
 #define WEB_SITE "http://www.filesdnd.fr"
 #define EN_WEB_SITE "http://www.filesdnd.com"
 #define SEND_TO_NAME "Files Drag and Drop.lnk"
@@ -53,6 +53,8 @@
 #define HISTORY_DELETE_FILE_ICON ":/images/icons/cross_red.png"
 #define HISTORY_REMOVE_ICON ":/images/icons/remove_history.png"
 #define HISTORY_LAUNCH_ICON ":/images/icons/launch_file.png"
+#define HISTORY_CANCEL_ICON ":/images/icons/cross_gray.png"
+#define HISTORY_CANCEL_HOVER_ICON ":/images/icons/cross_red.png"
 #define CLIPBOARD_ICON ":/images/icons/clipboard-paste.png"
 #define URL_ICON ":/images/flat/link-flat.png"
 #define TEXT_ICON ":/images/flat/pencil-flat.png"
@@ -72,6 +74,8 @@
 #define HOWTO_PANEL_CSS ":/css/common/css/howto.css"
 
 #define HISTORY_ICON_SIZE 16
+#define HISTORY_ROW_HEIGHT 50
+#define HISTORY_PROGRESS_HEIGHT 20
 #define FILE_ICON ":/fileIconFlat"
 #define XLSX_ICON ":/xlsxIconFlat"
 #define DOC_ICON ":/docIconFlat"
@@ -83,8 +87,16 @@
 
 #define OVERLAY_TIMEOUT (1000 * 10)
 #define BONJOUR_TIMEOUT (1000 * 25)
-#define READ_FILE_BUFFER 5000000
-#define MAX_HISTORY_SIZE 20
+#define CONNECTION_TIMEOUT 2000
+#define CONNECTION_ATTEMPT_DELAY 250
+#define SESSION_IDLE_TIMEOUT (1000 * 30)
+// Longer than the sender timeout, the sender is the one closing idle sessions
+#define SESSION_RECEIVE_TIMEOUT (SESSION_IDLE_TIMEOUT * 2)
+#define READ_FILE_BUFFER (256 * 1024)
+#define CHUNK_TARGET_INTERVAL 50 // ms of throughput per chunk
+#define RECEIVE_FILE_BUFFER (256 * 1024)
+#define ZERO_COPY_WAKEUP_BUFFER (64 * 1024)
+#define HISTORY_COMPACTION_MIN_RECORDS 128 // Dead records before the history file is compacted
 #define RESTART_REGISTER_TIMER (60000 * 10)
 #define FOCUSED_NETWORK_REFRESH 60 * 2 // 2 minutes
 #define NOTIFY_FACTOR (256 * 1024)
@@ -99,6 +111,7 @@
 #define KEY_UID "uid"
 #define KEY_TYPE "type"
 #define KEY_VERSION "version"
+#define KEY_FEATURES "features"
 
 #define TYPE_STRING_ANDROID "A"
 #define TYPE_STRING_MAC "M"
@@ -109,8 +122,18 @@
 #define BONJOUR_DOMAIN "local."
 
 #define LOG_FILE "filesdnd.log"
+#define LOG_BUFFER_SIZE 4096 // Lines, power of two
+#define LOG_FLUSH_INTERVAL 50 // ms
+#define LOG_SEGMENT_SIZE (1000 * 512)
+#define LOG_SEGMENT_COUNT 8 // Current log file included
+#define TRACE_FILE "filesdnd-trace.json"
+#define TRACE_MAX_EVENTS 200000
+#define METRICS_FILE "filesdnd-metrics.prom"
+#define METRICS_SOCKET_NAME "filesdnd-metrics"
+#define METRICS_BUCKET_COUNT 13 // Finite buckets of each histogram
 #define SETTINGS_FILE "settings.ini"
 #define HISTORY_FILE "history"
+#define HISTORY_COMPACTION_EXTENSION ".compact"
 
 #define DETECTED_BY_BONJOUR 1
 #define DETECTED_BY_UDP 2
@@ -118,6 +141,27 @@
 #define DEFAULT_DOWNLOAD_DIR "/Files Drag & Drop"
 #define DEFAULT_STORAGE_DIR "/Files Drag & Drop"
 #define ZIP_EXTENSION ".fdndzip"
+#define RESUME_EXTENSION ".fdndresume"
+#define RESUME_JOURNAL_INTERVAL (8 * 1024 * 1024)
+#define ARCHIVE_MAGIC 0x46444E44 // "FDND"
+#define ARCHIVE_LEGACY_VERSION 1
+#define ARCHIVE_VERSION 2
+#define ARCHIVE_CHUNK_SIZE (256 * 1024)
+
+// Optional protocol features, advertised by the receiver and acknowledged by the sender
+#define FEATURE_RESUME 0x01
+#define FEATURE_ARCHIVE_V2 0x02
+#define FEATURE_PIPELINE 0x04
+#define FEATURE_MULTISTREAM 0x08
+#define FEATURE_SESSION 0x10
+#define PROTOCOL_FEATURES (FEATURE_RESUME | FEATURE_ARCHIVE_V2 | FEATURE_PIPELINE | FEATURE_MULTISTREAM | FEATURE_SESSION)
+
+// Pipelined sending : files sent without waiting for their ACK, small files written at once
+#define PIPELINE_WINDOW 64
+#define PIPELINE_BATCH_SIZE (64 * 1024)
+
+// Files from this size may be split in byte ranges sent on several connections
+#define MULTISTREAM_MIN_SIZE (64 * 1024 * 1024)
 
 #define MULTICAST_ADDR "227.113.113.0"
 #define UDP_DISCOVERY_MULTICAST_PORT 60111
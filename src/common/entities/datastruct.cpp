@@ -19,6 +19,7 @@
 **************************************************************************************/
 
 #include "datastruct.h"
+#include "config/appconfig.h"
 
 DataStruct::DataStruct()
 {
@@ -38,3 +39,16 @@ bool DataStruct::isFileType(DataType type)
 
     return fileType;
 }
+
+bool DataStruct::hasResumeHandshake(unsigned features, qint64 fileSize)
+{
+    if (!(features & FEATURE_RESUME) || hasStreamHandshake(features, fileSize))
+        return false;
+
+    return (!(features & FEATURE_PIPELINE) || fileSize > PIPELINE_BATCH_SIZE);
+}
+
+bool DataStruct::hasStreamHandshake(unsigned features, qint64 fileSize)
+{
+    return (features & FEATURE_MULTISTREAM && fileSize >= MULTISTREAM_MIN_SIZE);
+}
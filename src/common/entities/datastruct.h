@@ -39,7 +39,11 @@ enum DataType
     TYPE_FILE_TOO_BIG,
     TYPE_FILE_SAVE,
     TYPE_URL_OPEN,
-    TYPE_MESSAGE
+    TYPE_MESSAGE,
+    TYPE_FEATURES,
+    TYPE_RESUME_OFFSET,
+    TYPE_STREAM_COUNT,
+    TYPE_STREAM_RANGE
 };
 
 /**
@@ -63,6 +67,22 @@ struct DataStruct
      * Is the specified type a file type
      */
     static bool isFileType(DataType type);
+    /**
+     * Does a file need the resume offset exchange before its content is sent
+     * Pipelined small files are not worth a round trip
+     *
+     * @param features Protocol features of the connection
+     * @param fileSize Size of the file
+     */
+    static bool hasResumeHandshake(unsigned features, qint64 fileSize);
+    /**
+     * Does a file need the stream count exchange before its content is sent
+     * The answer also carries the resume offset
+     *
+     * @param features Protocol features of the connection
+     * @param fileSize Size of the file
+     */
+    static bool hasStreamHandshake(unsigned features, qint64 fileSize);
 };
 
 #endif // DATASTRUCT_H
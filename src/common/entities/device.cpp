@@ -20,10 +20,12 @@
 
 #include "device.h"
 #include "helpers/logmanager.h"
+#include "helpers/metricsmanager.h"
 #include "appconfig.h"
 #include "helpers/filehelper.h"
 #include "udp/udpdiscovery.h"
-#include "helpers/folderzipper.h"
+#include "helpers/folderstreamer.h"
+#include "rangesender.h"
 #include "threads/deviceconnectionthreadevent.h"
 #include "threads/devicepingthreadevent.h"
 #include "threads/devicepongthreadevent.h"
@@ -34,10 +36,10 @@
 #include <QNetworkInterface>
 #include <QByteArray>
 #include <QHostAddress>
-#include <QStandardPaths>
 #include <QDir>
 #include <QTime>
 #include <QFileInfo>
+#include <QDateTime>
 
 Device::Device(QString name, QString stype, QString uid, QHostInfo info, int port, QString version) :
     _name(name),
@@ -49,10 +51,26 @@ Device::Device(QString name, QString stype, QString uid, QHostInfo info, int por
     _port(port),
     _progress(0),
     _downloadProgress(false),
+    _pendingDataType(-1),
     _lastState(NOSTATE),
+    _features(0),
+    _sessionFeatures(0),
     _pingTry(3),
     _pingTimer(this),
-    _tcpSocket(this)
+    _tcpSocket(new QTcpSocket(this)),
+    _attemptTimer(this),
+    _connectionTimer(this),
+    _idleTimer(this),
+    _sessionOpen(false),
+    _sessionReused(false),
+    _transfertAnswered(false),
+    _currentFolder(NULL),
+    _source(NULL),
+    _rangeEnd(0),
+    _pump(READ_FILE_BUFFER),
+    _pendingAcks(0),
+    _transferBytes(0),
+    _firstHeaderSent(false)
 {
     if (stype.contains(TYPE_STRING_ANDROID))
         _type = TYPE_ANDROID;
@@ -78,21 +96,36 @@ Device::Device(const Device &device) :
     _port(device._port),
     _progress(device._progress),
     _downloadProgress(device._downloadProgress),
+    _pendingDataType(-1),
     _lastState(device._lastState),
     _detectedBy(device._detectedBy),
+    _features(device._features),
+    _sessionFeatures(0),
     _filesToSend(device._filesToSend),
     _pingTry(device._pingTry),
     _pingTimer(this),
-    _tcpSocket(this)
+    _tcpSocket(new QTcpSocket(this)),
+    _attemptTimer(this),
+    _connectionTimer(this),
+    _idleTimer(this),
+    _sessionOpen(false),
+    _sessionReused(false),
+    _transfertAnswered(false),
+    _currentFolder(NULL),
+    _source(NULL),
+    _rangeEnd(0),
+    _pump(READ_FILE_BUFFER),
+    _pendingAcks(0),
+    _transferBytes(0),
+    _firstHeaderSent(false)
 {
     handleDeviceConstruction();
 }
 
 Device::~Device()
 {
+    closeSource();
     _pingTimer.stop();
-    _thread.quit();
-    _thread.wait();
 }
 
 void Device::handleDeviceConstruction()
@@ -101,24 +134,20 @@ void Device::handleDeviceConstruction()
     qRegisterMetaType<MessageType>("MessageType");
     qRegisterMetaType<QAbstractSocket::SocketError>("QAbstractSocket::SocketError");
 
-    moveToThread(&_thread);
-    _thread.start();
-
-    _tcpSocket.setSocketOption(QAbstractSocket::LowDelayOption, 1);
-    _tcpSocket.setSocketOption(QAbstractSocket::KeepAliveOption, 0);
-    _tcpSocket.setSocketOption(QAbstractSocket::MulticastTtlOption, 0);
-    _tcpSocket.setSocketOption(QAbstractSocket::MulticastLoopbackOption, 0);
+    setSocket(_tcpSocket);
 
     _pingTimer.setSingleShot(true);
     connect(&_pingTimer, SIGNAL(timeout()), this, SLOT(onPingTimerOut()));
 
-    connect(&_tcpSocket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(socketError(QAbstractSocket::SocketError)));
-    connect(&_tcpSocket, SIGNAL(connected()), this, SLOT(onDeviceConnected()));
-    connect(&_tcpSocket, SIGNAL(disconnected()), this, SLOT(onDeviceDisconnected()));
-    connect(&_tcpSocket, SIGNAL(readyRead()), this, SLOT(onDataReceived()));
+    _attemptTimer.setSingleShot(true);
+    connect(&_attemptTimer, SIGNAL(timeout()), this, SLOT(startConnectionAttempt()));
+    _connectionTimer.setSingleShot(true);
+    connect(&_connectionTimer, SIGNAL(timeout()), this, SLOT(onConnectionTimeout()));
+    _idleTimer.setSingleShot(true);
+    connect(&_idleTimer, SIGNAL(timeout()), this, SLOT(onSessionIdle()));
 
     if(_version.compare(PROTOCOL_VERSION) != 0) {
-        LogManager::appendLine("[Device] Device protocol version is " + _version + " (current is " PROTOCOL_VERSION + ")");
+        WARNING_LOG(LOG_CONNECTION, "[Device] Device protocol version is " + _version + " (current is " PROTOCOL_VERSION + ")");
         _lastState = DIFVERSION;
         setDeviceUnavailable();
     }
@@ -157,47 +186,224 @@ void Device::tryConnect()
 
 void Device::connectTo()
 {
-    bool connected = false;
-    if (!_tcpSocket.isOpen())
+    // A retry on a new connection continues the same transfer
+    if (!_transferSpan.isActive())
+        _transferSpan.begin(getTraceTrack(), "transfer", "transfer");
+    if (!_transferTimer.isValid())
     {
-        // We can also use QNetworkInterface::allAddresses() for more details
-        QList<QHostAddress> localAddressesList = QHostInfo::fromName(QHostInfo::localHostName()).addresses();
-        foreach (QHostAddress qhs, _hostInfo.addresses())
-        {
-            if (!localAddressesList.contains(qhs))
-            {
-                LogManager::appendLine("[Server] Try connecting to " + qhs.toString() + ":" + QString::number(_port));
-                _tcpSocket.connectToHost(QHostAddress(qhs.toString()), _port, QIODevice::ReadWrite);
-
-                if (_tcpSocket.waitForConnected(2000))
-                {
-                    LogManager::appendLine("[Server] Connected to " + qhs.toString());
-                    connected = true;
-                    break;
-                }
-            }
-        }
-        if (!connected)
+        _transferTimer.start();
+        _transferBytes = 0;
+        _firstHeaderSent = false;
+        _ackStarts.clear();
+    }
+
+    if (_sessionOpen)
+    {
+        _idleTimer.stop();
+        _sessionOpen = false;
+
+        // The handshake is already done, the transfer starts right away
+        if (isConnected())
         {
-            onTransfertFail();
-            LogManager::appendLine("[Server] Connection to device failed, no answer");
+            _sessionReused = true;
+            DEBUG_LOG(LOG_CONNECTION, "[Server] Reusing the session with " + _tcpSocket->peerAddress().toString());
+            onDeviceConnected();
+            return;
         }
+        _tcpSocket->close();
+    }
+
+    if (_tcpSocket->isOpen() || !_connectionAttempts.isEmpty())
+        return;
+
+    _sessionReused = false;
+
+    // We can also use QNetworkInterface::allAddresses() for more details
+    QList<QHostAddress> localAddressesList = QHostInfo::fromName(QHostInfo::localHostName()).addresses();
+    QHostAddress lastAddress(SettingsManager::getLastAddress(_uid));
+
+    _pendingAddresses.clear();
+    foreach (QHostAddress qhs, _hostInfo.addresses())
+    {
+        // Discovered devices never have a loopback address, it is only given on purpose (benchmark)
+        if (localAddressesList.contains(qhs) && qhs != QHostAddress(QHostAddress::LocalHost))
+            continue;
+
+        if (qhs == lastAddress)
+            _pendingAddresses.prepend(qhs);
+        else
+            _pendingAddresses.append(qhs);
+    }
+
+    if (_pendingAddresses.isEmpty())
+    {
+        onTransfertFail();
+        WARNING_LOG(LOG_CONNECTION, "[Server] Connection to device failed, no address");
+        return;
     }
+
+    _connectSpan.begin(getTraceTrack(), "connection", "connect");
+    startConnectionAttempt();
 }
 
+void Device::startConnectionAttempt()
+{
+    if (_pendingAddresses.isEmpty())
+        return;
+
+    QHostAddress address = _pendingAddresses.takeFirst();
+    QTcpSocket *socket = new QTcpSocket(this);
 
-void Device::socketError(QAbstractSocket::SocketError)
+    connect(socket, SIGNAL(connected()), this, SLOT(onAttemptConnected()));
+    connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(onAttemptFailed()));
+    _connectionAttempts.append(socket);
+
+    // The last attempt started gets the whole timeout
+    _connectionTimer.start(CONNECTION_TIMEOUT);
+    if (!_pendingAddresses.isEmpty())
+        _attemptTimer.start(CONNECTION_ATTEMPT_DELAY);
+
+    DEBUG_LOG(LOG_CONNECTION, "[Server] Try connecting to " + address.toString() + ":" + QString::number(_port));
+    socket->connectToHost(address, _port, QIODevice::ReadWrite);
+}
+
+void Device::onAttemptConnected()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+
+    if (!socket || !_connectionAttempts.removeOne(socket))
+        return;
+
+    disconnect(socket, 0, this, 0);
+    abortConnectionAttempts();
+
+    INFO_LOG(LOG_CONNECTION, "[Server] Connected to " + socket->peerAddress().toString());
+    _connectSpan.end(socket->peerAddress().toString());
+    SettingsManager::setLastAddress(_uid, socket->peerAddress().toString());
+
+    setSocket(socket);
+    onDeviceConnected();
+}
+
+void Device::onAttemptFailed()
 {
-    LogManager::appendLine("[Server] Socket ERROR - " + _tcpSocket.errorString() + " (IP - " + _tcpSocket.peerName() + ")");
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+
+    if (!socket || !_connectionAttempts.removeOne(socket))
+        return;
+
+    DEBUG_LOG(LOG_CONNECTION, "[Server] Connection attempt failed - " + socket->errorString());
+    disconnect(socket, 0, this, 0);
+    socket->deleteLater();
+
+    // No need to wait for the delay, race the next address now
+    if (!_pendingAddresses.isEmpty())
+        startConnectionAttempt();
+    else if (_connectionAttempts.isEmpty())
+        onConnectionTimeout();
+}
 
+void Device::onConnectionTimeout()
+{
+    abortConnectionAttempts();
     onTransfertFail();
+    WARNING_LOG(LOG_CONNECTION, "[Server] Connection to device failed, no answer");
+}
+
+void Device::abortConnectionAttempts()
+{
+    _attemptTimer.stop();
+    _connectionTimer.stop();
+    _pendingAddresses.clear();
+
+    foreach (QTcpSocket *socket, _connectionAttempts)
+    {
+        disconnect(socket, 0, this, 0);
+        socket->abort();
+        socket->deleteLater();
+    }
+    _connectionAttempts.clear();
+}
+
+void Device::setSocket(QTcpSocket *socket)
+{
+    if (_tcpSocket != socket)
+    {
+        disconnect(_tcpSocket, 0, this, 0);
+        _tcpSocket->abort();
+        _tcpSocket->deleteLater();
+        _tcpSocket = socket;
+    }
+
+    _tcpSocket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    _tcpSocket->setSocketOption(QAbstractSocket::KeepAliveOption, 0);
+    _tcpSocket->setSocketOption(QAbstractSocket::MulticastTtlOption, 0);
+    _tcpSocket->setSocketOption(QAbstractSocket::MulticastLoopbackOption, 0);
+
+    connect(_tcpSocket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(socketError(QAbstractSocket::SocketError)));
+    connect(_tcpSocket, SIGNAL(disconnected()), this, SLOT(onDeviceDisconnected()));
+    connect(_tcpSocket, SIGNAL(readyRead()), this, SLOT(onDataReceived()));
+}
+
+void Device::socketError(QAbstractSocket::SocketError)
+{
+    // The device closed the idle session, no transfer is lost
+    if (_sessionOpen)
+    {
+        closeSession();
+        return;
+    }
+
+    ERROR_LOG(LOG_CONNECTION, "[Server] Socket ERROR - " + _tcpSocket->errorString() + " (IP - " + _tcpSocket->peerName() + ")");
+
+    if (!retryOnNewConnection())
+        onTransfertFail();
+}
+
+void Device::closeSession()
+{
+    _idleTimer.stop();
+    _sessionOpen = false;
+    _tcpSocket->close();
+}
+
+void Device::onSessionIdle()
+{
+    DEBUG_LOG(LOG_CONNECTION, "[Server] Closing the idle session with " + _tcpSocket->peerAddress().toString());
+    closeSession();
+}
+
+bool Device::retryOnNewConnection()
+{
+    if (!_sessionReused || _transfertAnswered)
+        return false;
+
+    DEBUG_LOG(LOG_CONNECTION, "[Server] Session closed by the device, reconnecting");
+
+    _sessionReused = false;
+    abortStreams();
+    closeSource();
+    _tcpSocket->abort();
+    while (!_fileSpans.isEmpty())
+        _fileSpans.takeFirst().end("retried");
+    _ackStarts.clear();
+    _unackedFiles.clear();
+    _data = _sessionData;
+    connectTo();
+
+    return true;
 }
 
 void Device::onTransfertFail()
 {
+    endTraces("failed");
+    endMetrics(false);
+    _sessionReused = false;
+    abortConnectionAttempts();
+    abortStreams();
     _lastState = FAIL;
     setDeviceAvailable();
-    _tcpSocket.close();
+    closeSession();
 }
 
 void Device::ping(UdpDiscovery *udpDiscovery)
@@ -225,7 +431,8 @@ void Device::onPingTimerOut()
     else
     {
         _pingTry = 3;
-        if (!isConnected())
+        // An idle session does not mean the device is still there
+        if (!isConnected() || _sessionOpen)
             emit deviceDoNotRespond(this);
     }
 }
@@ -260,9 +467,22 @@ void Device::onDeviceConnected()
     _lastState = CONNECTED;
     setDeviceUnavailable();
 
-    sendUid();
-    sendName();
-    sendType();
+    _sessionData = _data;
+    _transfertAnswered = false;
+    _downloadProgress = false;
+    _pendingDataType = -1;
+
+    if (!_sessionReused)
+    {
+        TraceSpan handshakeSpan;
+
+        handshakeSpan.begin(getTraceTrack(), "connection", "handshake");
+        sendUid();
+        sendName();
+        sendType();
+        sendFeatures();
+        handshakeSpan.end();
+    }
 
     if (DataStruct::isFileType(_data._type))
         sendFiles();
@@ -272,12 +492,14 @@ void Device::onDeviceConnected()
 
 void Device::onDataReceived()
 {
-    QDataStream stream(&_tcpSocket);
+    QDataStream stream(_tcpSocket);
     unsigned dataType;
 
-    if (_tcpSocket.bytesAvailable() < sizeof(unsigned))
+    if (_tcpSocket->bytesAvailable() < sizeof(unsigned))
         return;
 
+    _transfertAnswered = true;
+
     do
     {
         if (_downloadProgress)
@@ -289,14 +511,60 @@ void Device::onDataReceived()
             continue;
         }
 
+        // The payload of a header may arrive in a later segment
+        if (_pendingDataType == TYPE_RESUME_OFFSET)
+        {
+            qint64 offset;
+
+            if (_tcpSocket->bytesAvailable() < (qint64)sizeof(qint64))
+                return;
+
+            stream >> offset;
+            _pendingDataType = -1;
+            startFileStream(offset);
+
+            continue;
+        }
+
+        if (_pendingDataType == TYPE_STREAM_COUNT)
+        {
+            unsigned streams;
+            quint32 token;
+            qint64 offset;
+
+            if (_tcpSocket->bytesAvailable() < (qint64)(sizeof(unsigned) + sizeof(quint32) + sizeof(qint64)))
+                return;
+
+            stream >> streams >> token >> offset;
+            _pendingDataType = -1;
+            startStreams(streams, token, offset);
+
+            continue;
+        }
+
         stream >> dataType;
 
         switch (dataType)
         {
         case TYPE_ACK:
-            LogManager::appendLine("[Server] SUCCESS - Ack received");
+            TRACE_LOG(LOG_TRANSFER, "[Server] SUCCESS - Ack received");
+            if (!_fileSpans.isEmpty())
+                _fileSpans.takeFirst().end();
+            if (!_unackedFiles.isEmpty())
+                _unackedFiles.removeFirst();
+            if (!_ackStarts.isEmpty() && _transferTimer.isValid())
+                MetricsManager::observe(METRIC_ACK_RTT, (_transferTimer.nsecsElapsed() - _ackStarts.takeFirst()) / 1e9);
             _progress = 0;
-            if (_data._urls.isEmpty())
+            if (_sessionFeatures & FEATURE_PIPELINE)
+            {
+                if (_pendingAcks > 0)
+                    --_pendingAcks;
+                if (_pendingAcks == 0 && !_source && _data._urls.isEmpty())
+                    transfertSucceded();
+                else
+                    fillPipeline();
+            }
+            else if (_data._urls.isEmpty())
                 transfertSucceded();
             else
                 trySendNextFile();
@@ -308,12 +576,17 @@ void Device::onDataReceived()
 
         case TYPE_FILE_TOO_BIG:
             onDeviceDisconnected();
-            LogManager::appendLine("[Server] ERROR - File too big");
+            ERROR_LOG(LOG_TRANSFER, "[Server] ERROR - File too big");
             _progress = 0;
             onTransfertFail();
             emit fileTooBig();
             break;
 
+        case TYPE_RESUME_OFFSET:
+        case TYPE_STREAM_COUNT:
+            _pendingDataType = dataType;
+            break;
+
         case TYPE_MESSAGE:
             unsigned messageType;
             QString message;
@@ -321,19 +594,22 @@ void Device::onDataReceived()
             stream >> messageType;
             stream >> message;
 
-            LogManager::appendLine("[Server] MESSAGE - " + message);
+            INFO_LOG(LOG_TRANSFER, "[Server] MESSAGE - " + message);
 
             emit displayMessage(MessageType(messageType), message);
             break;
         }
     }
-    while (_tcpSocket.bytesAvailable() >= sizeof(unsigned));
+    while (_tcpSocket->bytesAvailable() >= sizeof(unsigned));
 }
 
 QString Device::getDisplayMessage()
 {
     QString message;
-    QString filename = _data._string.split('/').last();
+    // Pipelined files are sent ahead of the one being received
+    QString current = _unackedFiles.isEmpty() ? _data._string : _unackedFiles.first();
+    QString filename = current.split('/').last();
+    int remaining = _data._urls.size() + qMax(_unackedFiles.size() - 1, 0);
     int maxFilenameLenght = 15;
 
     filename.remove(ZIP_EXTENSION);
@@ -345,7 +621,7 @@ QString Device::getDisplayMessage()
     if (_filesToSend > 1)
     {
         message.append(" (");
-        message.append(QString::number(_filesToSend - _data._urls.size()));
+        message.append(QString::number(_filesToSend - remaining));
         message.append("/");
         message.append(QString::number(_filesToSend));
         message.append(")");
@@ -356,7 +632,7 @@ QString Device::getDisplayMessage()
 
 bool Device::isConnected()
 {
-    return (_tcpSocket.state() == QAbstractSocket::ConnectedState);
+    return (_tcpSocket->state() == QAbstractSocket::ConnectedState);
 }
 
 void Device::sendString()
@@ -374,7 +650,7 @@ void Device::sendString()
     stream.device()->seek(sizeof(unsigned));
     stream << (quint32)(data.size() - (sizeof(unsigned) * 2));
 
-    _tcpSocket.write(data);
+    _tcpSocket->write(data);
 }
 
 void Device::sendUid()
@@ -385,7 +661,7 @@ void Device::sendUid()
     // String to send
     stream << SettingsManager::getDeviceUID();
 
-    _tcpSocket.write(data);
+    _tcpSocket->write(data);
 }
 
 void Device::sendName()
@@ -396,7 +672,7 @@ void Device::sendName()
     // String to send
     stream << SettingsManager::getServiceDeviceName();
 
-    _tcpSocket.write(data);
+    _tcpSocket->write(data);
 }
 
 void Device::sendType()
@@ -407,38 +683,50 @@ void Device::sendType()
     // String to send
     stream << QString(SettingsManager::getType());
 
-    _tcpSocket.write(data);
+    _tcpSocket->write(data);
+}
+
+void Device::sendFeatures()
+{
+    _sessionFeatures = _features & PROTOCOL_FEATURES;
+    if (!SettingsManager::isPersistentSessionsEnabled())
+        _sessionFeatures &= ~FEATURE_SESSION;
+
+    // Peers that do not advertise any feature do not know this header
+    if (_sessionFeatures)
+    {
+        QByteArray data;
+        QDataStream stream(&data, QIODevice::WriteOnly);
+
+        // Data type
+        stream << (unsigned)TYPE_FEATURES;
+        // Features used for this connection
+        stream << (unsigned)_sessionFeatures;
+
+        _tcpSocket->write(data);
+    }
 }
 
 bool Device::sendNextFile()
 {
     bool canSend = false;
-    bool compress = true;
 
     if (!_data._urls.isEmpty())
     {
         QUrl current = _data._urls.takeFirst();
         _data._string = FileHelper::getFilePath(current.toString());
 
-        LogManager::appendLine("[Server] Sending file " + _data._string);
+        INFO_LOG(LOG_TRANSFER, "[Server] Sending file " + _data._string);
 
         QFileInfo file(_data._string);
         if (file.isDir())
         {
-            QString dirName = file.dir().dirName();
-            QString tmp = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
-            tmp = QDir::fromNativeSeparators(tmp);
-            QString destination = tmp + "/" + dirName + ZIP_EXTENSION;
-
-            LogManager::appendLine("[Server] Zipping directory (" + destination + ")");
-            compress = FolderZipper::compressFolder(_data._string, destination);
-            _data._string = destination;
+            // Drop the trailing separator, the folder name is used as the archive name
+            _data._string = QDir::cleanPath(_data._string);
+            INFO_LOG(LOG_TRANSFER, "[Server] Streaming directory " + _data._string);
         }
-        if (compress)
-            sendFile();
-        else
-            return sendNextFile();
 
+        sendFile();
         canSend = true;
     }
 
@@ -456,9 +744,17 @@ void Device::sendFiles()
     // Datagram size
     stream << (unsigned)_filesToSend;
 
-    _tcpSocket.write(data);
+    _tcpSocket->write(data);
 
-    trySendNextFile();
+    _pendingAcks = 0;
+    _unackedFiles.clear();
+    _batch.clear();
+    _pump.resetChunkSize(SettingsManager::getChunkSize(_uid));
+
+    if (_sessionFeatures & FEATURE_PIPELINE)
+        fillPipeline();
+    else
+        trySendNextFile();
 }
 
 void Device::trySendNextFile()
@@ -469,9 +765,76 @@ void Device::trySendNextFile()
     }
 }
 
+void Device::fillPipeline()
+{
+    // A file still streamed or waiting for its resume offset blocks the pipeline
+    while (_tcpSocket->isOpen() && !_source && !_data._urls.isEmpty() && _pendingAcks < PIPELINE_WINDOW)
+    {
+        if (_tcpSocket->bytesToWrite() + _batch.size() >= getHighWatermark())
+        {
+            // Continue once the socket drained
+            connect(_tcpSocket, SIGNAL(bytesWritten(qint64)), this, SLOT(onBatchWritten(qint64)), Qt::UniqueConnection);
+            break;
+        }
+
+        sendNextFile();
+
+        if (_batch.size() >= PIPELINE_BATCH_SIZE)
+            flushBatch();
+    }
+
+    flushBatch();
+}
+
+void Device::onBatchWritten(qint64)
+{
+    if (_tcpSocket->bytesToWrite() > getHighWatermark() / 2)
+        return;
+
+    disconnect(_tcpSocket, SIGNAL(bytesWritten(qint64)), this, SLOT(onBatchWritten(qint64)));
+    fillPipeline();
+}
+
+qint64 Device::getHighWatermark() const
+{
+    qint64 budget = SettingsManager::getSendBufferSize() / (_rangeSenders.size() + 1);
+
+    return qMax(budget, (qint64)READ_FILE_BUFFER);
+}
+
+void Device::flushBatch()
+{
+    if (!_batch.isEmpty())
+    {
+        _tcpSocket->write(_batch);
+        _batch.clear();
+    }
+}
+
 void Device::transfertSucceded()
 {
-    _tcpSocket.close();
+    // Record the chunk size the transfer converged to, the next one starts from it
+    const ChunkSizer &chunkSizer = _pump.getChunkSizer();
+
+    if (chunkSizer.getThroughput() > 0)
+    {
+        SettingsManager::setChunkSize(_uid, chunkSizer.getChunkSize());
+        DEBUG_LOG(LOG_TRANSFER, "[Server] Chunk size converged to " + QString::number(chunkSizer.getChunkSize())
+                                + " bytes (" + QString::number(chunkSizer.getThroughput() / 1024) + " KB/s)");
+    }
+
+    abortStreams();
+    endTraces("succeeded");
+    endMetrics(true);
+    _sessionReused = false;
+    if (_sessionFeatures & FEATURE_SESSION && isConnected())
+    {
+        // Keep the connection for the next transfers to this device
+        _sessionOpen = true;
+        _idleTimer.start(SESSION_IDLE_TIMEOUT);
+    }
+    else
+        _tcpSocket->close();
     _lastState = SUCCESS;
     setDeviceAvailable();
 }
@@ -480,46 +843,229 @@ void Device::sendFile()
 {
     QByteArray data;
     QDataStream stream(&data, QIODevice::WriteOnly);
+    QString filename = _data._string.split('/').last();
 
-
-    _currentFile.setFileName(_data._string);
+    closeSource();
     _bytesSent = 0;
     _fileSize = 0;
 
-    if (!_currentFile.open(QIODevice::ReadOnly))
+    if (QFileInfo(_data._string).isDir())
+    {
+        quint32 version = (_sessionFeatures & FEATURE_ARCHIVE_V2) ? ARCHIVE_VERSION : ARCHIVE_LEGACY_VERSION;
+
+        _currentFolder = new FolderStreamer(_data._string, version);
+        _source = _currentFolder;
+        filename += ZIP_EXTENSION;
+    }
+    else
+    {
+        _currentFile.setFileName(_data._string);
+        _source = &_currentFile;
+    }
+
+    if (!_source->open(QIODevice::ReadOnly))
     {
+        closeSource();
         onTransfertFail();
-        LogManager::appendLine("[Server] ERROR - Cannot open file " + _currentFile.fileName());
+        ERROR_LOG(LOG_TRANSFER, "[Server] ERROR - Cannot open file " + _data._string);
 
         return;
     }
 
-    _fileSize = _currentFile.size();
+    _fileSize = _source->size();
+    _rangeEnd = _fileSize;
+    _pump.setZeroCopy(_source == &_currentFile);
+
+    _unackedFiles.append(_data._string);
+
+    // Sent until acknowledged, folders are zipped while streamed
+    _fileSpans.append(TraceSpan());
+    _fileSpans.last().begin(getTraceTrack(), "transfer", _currentFolder ? "folder" : "file", filename);
+    _transferBytes += _fileSize;
+    if (!_firstHeaderSent && _transferTimer.isValid())
+    {
+        _firstHeaderSent = true;
+        MetricsManager::observe(METRIC_TIME_TO_FIRST_BYTE, _transferTimer.nsecsElapsed() / 1e9);
+    }
 
     // File size
     stream << _fileSize;
     // File name
-    stream << _currentFile.fileName().split('/').last();
+    stream << filename;
+
+    if (_sessionFeatures & FEATURE_PIPELINE)
+        ++_pendingAcks;
+
+    if (DataStruct::hasStreamHandshake(_sessionFeatures, _fileSize))
+    {
+        // Folders are produced sequentially, they cannot be split in ranges
+        unsigned streams = _currentFolder ? 1 : qMax(1, SettingsManager::getStreamCount(_uid));
+
+        // The receiver answers with the accepted stream count and the offset to start from
+        if (_sessionFeatures & FEATURE_RESUME)
+            stream << QFileInfo(_data._string).lastModified().toMSecsSinceEpoch();
+        stream << streams;
+        _batch.append(data);
+        flushBatch();
+    }
+    else if (DataStruct::hasResumeHandshake(_sessionFeatures, _fileSize))
+    {
+        // Modification date, the receiver answers with the offset to start from
+        stream << QFileInfo(_data._string).lastModified().toMSecsSinceEpoch();
+        _batch.append(data);
+        flushBatch();
+    }
+    else if (_sessionFeatures & FEATURE_PIPELINE && _fileSize <= PIPELINE_BATCH_SIZE)
+    {
+        QByteArray content = _source->read(_fileSize);
+
+        // The announced size must be honored, even if the file shrunk
+        if (content.size() < _fileSize)
+            content.append(QByteArray(_fileSize - content.size(), 0));
+
+        _batch.append(data);
+        _batch.append(content);
+        _bytesSent = _fileSize;
+        MetricsManager::increment(METRIC_BYTES_SENT, _fileSize);
+        _ackStarts.append(_transferTimer.nsecsElapsed());
+        closeSource();
+    }
+    else
+    {
+        connect(_tcpSocket, SIGNAL(bytesWritten(qint64)), this, SLOT(onBytesWritten(qint64)));
+        _batch.append(data);
+        flushBatch();
+    }
+}
 
-    connect(&_tcpSocket, SIGNAL(bytesWritten(qint64)), this, SLOT(onBytesWritten(qint64)));
+void Device::closeSource()
+{
+    if (_source)
+        _source->close();
 
-    _tcpSocket.write(data);
+    delete _currentFolder;
+    _currentFolder = NULL;
+    _source = NULL;
 }
 
-void Device::onBytesWritten(qint64)
+void Device::startFileStream(qint64 offset)
+{
+    if (!_source || !_source->isOpen())
+        return;
+
+    if (offset > 0 && offset < _fileSize && !_source->isSequential() && _source->seek(offset))
+    {
+        INFO_LOG(LOG_TRANSFER, "[Server] Resuming " + _data._string + " at " + QString::number(offset));
+        _bytesSent = offset;
+    }
+
+    connect(_tcpSocket, SIGNAL(bytesWritten(qint64)), this, SLOT(onBytesWritten(qint64)));
+    onBytesWritten(0);
+}
+
+void Device::startStreams(unsigned streams, quint32 token, qint64 offset)
+{
+    if (streams <= 1 || !_source || _source->isSequential())
+    {
+        startFileStream(offset);
+        return;
+    }
+
+    qint64 rangeSize = _fileSize / streams;
+    qint64 highWatermark = qMax((qint64)SettingsManager::getSendBufferSize() / streams, (qint64)READ_FILE_BUFFER);
+
+    INFO_LOG(LOG_TRANSFER, "[Server] Sending " + _data._string + " on " + QString::number(streams) + " streams");
+
+    for (unsigned i = 1; i < streams; ++i)
+    {
+        qint64 rangeOffset = rangeSize * i;
+        qint64 rangeLength = (i == streams - 1) ? _fileSize - rangeOffset : rangeSize;
+        RangeSender *sender = new RangeSender(_data._string, rangeOffset, rangeLength, highWatermark, this);
+
+        connect(sender, SIGNAL(finished(RangeSender*)), this, SLOT(onRangeFinished(RangeSender*)));
+        connect(sender, SIGNAL(failed(RangeSender*)), this, SLOT(onRangeFailed(RangeSender*)));
+        _rangeSenders.append(sender);
+        sender->start(_tcpSocket->peerAddress(), _port, getStreamHeader(token, rangeOffset, rangeLength));
+    }
+
+    // The main connection sends the first range
+    _rangeEnd = rangeSize;
+    startFileStream(0);
+}
+
+QByteArray Device::getStreamHeader(quint32 token, qint64 offset, qint64 length) const
 {
     QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+
+    stream << SettingsManager::getDeviceUID();
+    stream << SettingsManager::getServiceDeviceName();
+    stream << QString(SettingsManager::getType());
+    // Data type
+    stream << (unsigned)TYPE_STREAM_RANGE;
+    // Datagram size, a single range
+    stream << (unsigned)1;
+    // Range of the file
+    stream << token << offset << length;
+
+    return data;
+}
+
+void Device::onRangeFinished(RangeSender *sender)
+{
+    _rangeSenders.removeOne(sender);
+    sender->deleteLater();
+}
+
+void Device::onRangeFailed(RangeSender *)
+{
+    ERROR_LOG(LOG_TRANSFER, "[Server] ERROR - Stream failed, canceling the transfer");
+
+    onTransfertFail();
+}
+
+void Device::abortStreams()
+{
+    foreach (RangeSender *sender, _rangeSenders)
+    {
+        sender->abort();
+        sender->deleteLater();
+    }
+    _rangeSenders.clear();
+}
+
+void Device::onBytesWritten(qint64)
+{
+    SendPump::Status status = SendPump::Finished;
+
+    if (_source && _tcpSocket->isOpen())
+        status = _pump.pump(_source, _tcpSocket, _bytesSent, _rangeEnd, getHighWatermark());
+
+    if (status == SendPump::Waiting)
+        return;
+
+    disconnect(_tcpSocket, SIGNAL(bytesWritten(qint64)), this, SLOT(onBytesWritten(qint64)));
 
-    if (_bytesSent == _fileSize || !_tcpSocket.isOpen())
+    if (status == SendPump::Failed)
     {
-        disconnect(&_tcpSocket, SIGNAL(bytesWritten(qint64)), this, SLOT(onBytesWritten(qint64)));
-        _currentFile.close();
+        ERROR_LOG(LOG_TRANSFER, "[Server] ERROR - Cannot read " + _data._string);
+        closeSource();
+        onTransfertFail();
 
         return;
     }
 
-    data = _currentFile.read(READ_FILE_BUFFER);
-    _bytesSent += _tcpSocket.write(data);
+    if (_source && _bytesSent == _rangeEnd)
+        _ackStarts.append(_transferTimer.nsecsElapsed());
+    closeSource();
+
+    if (_sessionFeatures & FEATURE_PIPELINE && _tcpSocket->isOpen())
+    {
+        if (_pendingAcks == 0 && _data._urls.isEmpty())
+            transfertSucceded();
+        else
+            fillPipeline();
+    }
 }
 
 void Device::setDataStruct(const DataStruct &dataStruct)
@@ -534,8 +1080,17 @@ unsigned Device::getProgress()
 
 void Device::onDeviceDisconnected()
 {
-    _tcpSocket.abort();
-    _tcpSocket.close();
+    if (_sessionOpen)
+    {
+        closeSession();
+        return;
+    }
+
+    if (retryOnNewConnection())
+        return;
+
+    _tcpSocket->abort();
+    _tcpSocket->close();
 }
 
 bool Device::isAvailable()
@@ -581,6 +1136,16 @@ void Device::setVersion(QString version)
 }
 
 
+unsigned Device::getFeatures() const
+{
+    return _features;
+}
+
+void Device::setFeatures(unsigned features)
+{
+    _features = features;
+}
+
 bool Device::isDetectedBy(int value)
 {
     return (_detectedBy & value);
@@ -634,13 +1199,16 @@ bool Device::event(QEvent *event)
 
 void Device::cancelTransfert()
 {
-    LogManager::appendLine("[Server] ERROR - Transfert canceled by user");
+    INFO_LOG(LOG_TRANSFER, "[Server] ERROR - Transfert canceled by user");
+    endTraces("canceled");
+    endMetrics(false);
 
     _lastState = CANCELED;
+    _sessionReused = false;
     setDeviceAvailable();
-    emit _tcpSocket.error(QAbstractSocket::ConnectionRefusedError);
-    _tcpSocket.abort();
-    _tcpSocket.close();
+    emit _tcpSocket->error(QAbstractSocket::ConnectionRefusedError);
+    _tcpSocket->abort();
+    _tcpSocket->close();
 }
 
 void Device::setBonjourRecord(const BonjourRecord &record)
@@ -652,3 +1220,30 @@ const BonjourRecord Device::getBonjourRecord() const
 {
     return _bonjourRecord;
 }
+
+QString Device::getTraceTrack() const
+{
+    // The display name may change or be shared by several devices
+    return "Device " + _uid;
+}
+
+void Device::endMetrics(bool succeeded)
+{
+    if (!_transferTimer.isValid())
+        return;
+
+    qint64 elapsed = _transferTimer.nsecsElapsed();
+
+    if (succeeded && _transferBytes > 0 && elapsed > 0)
+        MetricsManager::observe(METRIC_TRANSFER_THROUGHPUT, _transferBytes * 1e9 / elapsed);
+    _transferTimer.invalidate();
+    _ackStarts.clear();
+}
+
+void Device::endTraces(const QString &result)
+{
+    _connectSpan.end(result);
+    while (!_fileSpans.isEmpty())
+        _fileSpans.takeFirst().end(result);
+    _transferSpan.end(result);
+}
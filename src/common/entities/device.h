@@ -22,19 +22,24 @@
 #define DEVICE_H
 
 #include <QString>
+#include <QStringList>
 #include <QHostInfo>
 #include <QTimer>
 #include <QTcpSocket>
 #include <QThread>
 #include <QHostAddress>
 #include <QEvent>
+#include <QElapsedTimer>
 
 #include "bonjourrecord.h"
 #include "entities/datastruct.h"
 #include "helpers/settingsmanager.h"
-#include "threads/devicethread.h"
+#include "helpers/sendpump.h"
+#include "helpers/tracemanager.h"
 
 class UdpDiscovery;
+class FolderStreamer;
+class RangeSender;
 
 /**
   * @enum DeviceType
@@ -186,6 +191,47 @@ public:
       * Try to send the next file. If no file can be sent, emit the end signal
       */
     void trySendNextFile();
+    /**
+      * Pipelined sending : start the next files as long as the window allows it
+      * Small files are coalesced in the batch and written at once
+      */
+    void fillPipeline();
+    /**
+      * Write the pending batch to the socket
+      */
+    void flushBatch();
+    /**
+      * Bytes of file data the main connection may queue before waiting for the socket
+      * SettingsManager::getSendBufferSize() is shared by all the connections of the device
+      */
+    qint64 getHighWatermark() const;
+    /**
+      * Header of an extra connection of a multi-stream transfer
+      */
+    QByteArray getStreamHeader(quint32 token, qint64 offset, qint64 length) const;
+    /**
+      * Close the extra connections of a multi-stream transfer
+      */
+    void abortStreams();
+    /**
+      * Stop the connection attempts still running
+      */
+    void abortConnectionAttempts();
+    /**
+      * Use a connected socket for the transfers, the previous one is deleted
+      */
+    void setSocket(QTcpSocket *socket);
+    /**
+      * Close the persistent session kept open between transfers
+      */
+    void closeSession();
+    /**
+      * The reused session was closed by the device before it answered,
+      * send the transfer again on a new connection
+      *
+      * @return True if the transfer is retried, false if it failed
+      */
+    bool retryOnNewConnection();
     /**
       * Send a list of files
       */
@@ -212,6 +258,18 @@ public:
      * @param
      */
     void setVersion(QString version);
+    /**
+     * Getter : _features
+     *
+     * @return Protocol features advertised by the device
+     */
+    unsigned getFeatures() const;
+    /**
+     * Setter : _features
+     *
+     * @param features Protocol features advertised by the device
+     */
+    void setFeatures(unsigned features);
     /**
      * Getter : _detectedBy
      *
@@ -282,8 +340,32 @@ public slots:
       *
       * @param info Informations about the device (addresses, etc.)
       * @param port Port of the service
+      *
+      * All the addresses of the device are raced, a new attempt starting every
+      * CONNECTION_ATTEMPT_DELAY ms (or as soon as one fails), the first connected wins.
+      * The address that won last time is tried first.
       */
     void connectTo();
+    /**
+      * SLOT : Start the connection attempt to the next address
+      */
+    void startConnectionAttempt();
+    /**
+      * SLOT : A connection attempt succeeded, its socket becomes the device socket
+      */
+    void onAttemptConnected();
+    /**
+      * SLOT : A connection attempt failed, try the next address
+      */
+    void onAttemptFailed();
+    /**
+      * SLOT : No address answered in time
+      */
+    void onConnectionTimeout();
+    /**
+      * SLOT : No transfer used the persistent session for SESSION_IDLE_TIMEOUT ms
+      */
+    void onSessionIdle();
     /**
       * On connection failed
       *
@@ -292,7 +374,7 @@ public slots:
     void socketError(QAbstractSocket::SocketError );
     /**
       * On device connected
-      * Send data (file, text)
+      * Send data (file, text), the handshake is skipped on a reused session
       */
     void onDeviceConnected();
     /**
@@ -302,8 +384,13 @@ public slots:
     void onDeviceDisconnected();
     /**
       * Send the file described in _data on the network by the socket
+      * Folders are sent as an archive produced while it is uploaded
       */
     void sendFile();
+    /**
+     * Close the file or the folder stream being uploaded
+     */
+    void closeSource();
     /**
       * Send the string described in _data on the network by the socket
       * Could be plain, html or even url
@@ -333,6 +420,37 @@ public slots:
      * Send the type of the device through the socket
      */
     void sendType();
+    /**
+     * Send the protocol features used for this connection, if the device supports any
+     */
+    void sendFeatures();
+    /**
+     * Start streaming the current file
+     *
+     * @param offset Offset from which the receiver needs the file
+     */
+    void startFileStream(qint64 offset);
+    /**
+     * Start streaming the current file on the number of connections accepted by the receiver
+     * The main connection sends the first range, a RangeSender is opened for each other range
+     *
+     * @param streams Number of connections accepted by the receiver
+     * @param token Transfer token to send on the extra connections
+     * @param offset Offset from which the receiver needs the file (single stream only)
+     */
+    void startStreams(unsigned streams, quint32 token, qint64 offset);
+    /**
+     * SLOT : the socket drained below the low watermark, continue the pipeline
+     */
+    void onBatchWritten(qint64 bytes);
+    /**
+     * SLOT : a range of the current file has been sent
+     */
+    void onRangeFinished(RangeSender *sender);
+    /**
+     * SLOT : a range of the current file cannot be sent, the transfer fails
+     */
+    void onRangeFailed(RangeSender *sender);
     /**
      * SLOT : on ping timer out, request another ping or delete the device (if 3 ping failed)
      */
@@ -340,6 +458,10 @@ public slots:
 
     /**
      * On file bytes written on the socket
+     * On Linux the file is moved to the socket by the kernel while it accepts data,
+     * the buffered path only queues the bytes needed to be notified when it drains.
+     * Otherwise the file is read once the socket went below the low watermark (half of
+     * the high one), and only up to the high watermark
      */
     void onBytesWritten(qint64 bytes);
 
@@ -394,7 +516,25 @@ private:
     /// Port by udp
     int _port;
     /// Socket for the real device connection
-    QTcpSocket _tcpSocket;
+    QTcpSocket *_tcpSocket;
+    /// Sockets racing to connect to the device
+    QList<QTcpSocket *> _connectionAttempts;
+    /// Addresses not tried yet
+    QList<QHostAddress> _pendingAddresses;
+    /// Starts the next connection attempt
+    QTimer _attemptTimer;
+    /// Gives up the connection attempts
+    QTimer _connectionTimer;
+    /// Closes the persistent session once idle
+    QTimer _idleTimer;
+    /// The connection is kept open, waiting for the next transfer
+    bool _sessionOpen;
+    /// The current transfer reuses a persistent session
+    bool _sessionReused;
+    /// The device answered since the current transfer started
+    bool _transfertAnswered;
+    /// Data of the current transfer, sent again if the reused session was already closed
+    DataStruct _sessionData;
     /// Defines the data to send
     DataStruct _data;
     /// Defines if the device is available
@@ -403,20 +543,24 @@ private:
     unsigned _progress;
     /// Next data will be the download progress
     bool _downloadProgress;
+    /// Data type whose payload has not been entirely received yet, -1 if none
+    int _pendingDataType;
     /// Last transfert State
     TransfertState _lastState;
     /// Number of files to be sent
     qint64 _filesToSend;
     /// Binary detection
     int _detectedBy;
+    /// Protocol features advertised by the device
+    unsigned _features;
+    /// Protocol features used on the current connection
+    unsigned _sessionFeatures;
     /// Number of pending ping try
     unsigned _pingTry;
     /// Timer for ping request
     QTimer _pingTimer;
     /// Udp discovery module
     UdpDiscovery *_udpDiscovery;
-    /// Associated thread
-    DeviceThread _thread;
     /// Bonjour record associated to the bonjour detection, may not be setted
     BonjourRecord _bonjourRecord;
 
@@ -426,6 +570,55 @@ private:
     qint64 _bytesSent;
     /// Current file that is uploaded
     QFile _currentFile;
+    /// Current folder that is uploaded, null if the current data is a file
+    FolderStreamer *_currentFolder;
+    /// Device read for the upload, the current file or folder
+    QIODevice *_source;
+    /// End of the range sent on the main connection
+    qint64 _rangeEnd;
+    /// Sends the range of the main connection
+    SendPump _pump;
+    /// Extra connections of a multi-stream transfer
+    QList<RangeSender*> _rangeSenders;
+    /// Number of files sent and not acknowledged yet (pipelined sending)
+    unsigned _pendingAcks;
+    /// Headers and small files waiting to be written to the socket
+    QByteArray _batch;
+    /// Trace of the whole transfer
+    TraceSpan _transferSpan;
+    /// Trace of the connection to the device
+    TraceSpan _connectSpan;
+    /// Traces of the files sent and not acknowledged yet
+    QList<TraceSpan> _fileSpans;
+    /// Time since the transfer started, invalid between transfers
+    QElapsedTimer _transferTimer;
+    /// Bytes of the files of the transfer
+    qint64 _transferBytes;
+    /// True once the first file header of the transfer has been sent
+    bool _firstHeaderSent;
+    /// Times the files not acknowledged yet were entirely written, from _transferTimer
+    QList<qint64> _ackStarts;
+    /// Paths of the files sent and not acknowledged yet, the receiver is on the first one
+    QStringList _unackedFiles;
+
+    /**
+     * Get the trace track of the device
+     *
+     * @return The track name
+     */
+    QString getTraceTrack() const;
+    /**
+     * End the traces of a transfer
+     *
+     * @param result Result of the transfer
+     */
+    void endTraces(const QString &result);
+    /**
+     * Record the metrics of the transfer, nothing is done if no transfer is running
+     *
+     * @param succeeded True if the transfer succeeded
+     */
+    void endMetrics(bool succeeded);
 
     /**
      * Handle the device construction, initialize it
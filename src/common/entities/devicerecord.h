@@ -0,0 +1,60 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#ifndef DEVICERECORD_H
+#define DEVICERECORD_H
+
+#include <QString>
+#include <QHostInfo>
+
+#include "bonjourrecord.h"
+
+/**
+  * @struct DeviceRecord
+  *
+  * Device as announced by the discovery (UDP or Bonjour)
+  * Cheap to copy, the model only creates a Device for an uid it does not know yet
+  */
+struct DeviceRecord
+{
+    ///Constructor
+    DeviceRecord();
+
+    /// Label of the device
+    QString _name;
+    /// Device type in string
+    QString _type;
+    /// Unique UID
+    QString _uid;
+    /// Protocol version of the device
+    QString _version;
+    /// Port of the service
+    int _port;
+    /// Protocol features advertised by the device
+    unsigned _features;
+    /// Addresses of the device
+    QHostInfo _hostInfo;
+    /// Detection type (DETECTED_BY_UDP, DETECTED_BY_BONJOUR)
+    int _detectedBy;
+    /// Bonjour record, only set for a Bonjour detection
+    BonjourRecord _bonjourRecord;
+};
+
+#endif // DEVICERECORD_H
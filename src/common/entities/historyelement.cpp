@@ -115,6 +115,11 @@ qint64 HistoryElement::getSize()
     return _size;
 }
 
+QDateTime HistoryElement::getDate() const
+{
+    return _date;
+}
+
 QString HistoryElement::getDateTime(const QString &format) const
 {
     return _date.toString(format);
@@ -96,6 +96,10 @@ public:
       * Getter : _size
       */
     qint64 getSize();
+    /**
+     * Getter : _date
+     */
+    QDateTime getDate() const;
     /**
      * Getter : _date
      *
@@ -0,0 +1,333 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#include "historystore.h"
+#include "threads/historycompactionthread.h"
+#include "helpers/logmanager.h"
+#include "helpers/metricsmanager.h"
+#include "config/appconfig.h"
+
+#include <QDataStream>
+#include <QElapsedTimer>
+
+HistoryStore::HistoryStore(const QString &fileName, QObject *parent) :
+    QObject(parent),
+    _fileName(fileName),
+    _file(fileName),
+    _nextId(0),
+    _deadRecords(0),
+    _compactedDeadRecords(0),
+    _compactionThread(0)
+{
+}
+
+HistoryStore::~HistoryStore()
+{
+    if (_compactionThread)
+    {
+        _compactionThread->wait();
+        onCompactionFinished();
+    }
+    _file.close();
+}
+
+bool HistoryStore::load()
+{
+    QString compactedFileName = _fileName + HISTORY_COMPACTION_EXTENSION;
+    int records = 0;
+    QList<quint32> ids;
+    QHash<quint32, HistoryElement> elements;
+
+    // Interrupted between the removal of the old file and the rename of the compacted one
+    if (!QFile::exists(_fileName) && QFile::exists(compactedFileName))
+        QFile::rename(compactedFileName, _fileName);
+    else
+        QFile::remove(compactedFileName);
+
+    _file.close();
+    clearElements();
+    _nextId = 0;
+
+    if (!_file.exists())
+    {
+        openFile();
+        return false;
+    }
+
+    if (_file.open(QIODevice::ReadWrite))
+    {
+        QDataStream in(&_file);
+        qint64 validSize = 0;
+
+        while (!in.atEnd())
+        {
+            QByteArray record;
+
+            in >> record;
+            if (in.status() != QDataStream::Ok || !applyRecord(record, ids, elements))
+                break;
+
+            validSize = _file.pos();
+            ++records;
+        }
+
+        // Drop a record partially written when the application stopped
+        if (validSize < _file.size())
+        {
+            WARNING_LOG(LOG_HISTORY, "[History] Truncated record dropped");
+            _file.resize(validSize);
+        }
+        _file.close();
+    }
+
+    // Removed elements are skipped once, instead of being searched for each remove record
+    for (int i = ids.size() - 1; i >= 0; --i)
+    {
+        QHash<quint32, HistoryElement>::const_iterator it = elements.constFind(ids.at(i));
+
+        if (it != elements.constEnd())
+        {
+            _ids.append(it.key());
+            _elements.append(it.value());
+        }
+    }
+
+    _deadRecords = records - _ids.size();
+    openFile();
+    compactIfNeeded();
+
+    return true;
+}
+
+void HistoryStore::remove()
+{
+    if (_compactionThread)
+    {
+        _compactionThread->wait();
+        onCompactionFinished();
+    }
+
+    _file.close();
+    _file.remove();
+    clearElements();
+    _deadRecords = 0;
+}
+
+void HistoryStore::append(const HistoryElement &element)
+{
+    quint32 id = _nextId++;
+    TraceSpan span;
+
+    span.begin("History", "history", "append");
+    _elements.prepend(element);
+    _ids.prepend(id);
+    writeRecord(createRecord(RECORD_ADD, id, element));
+    span.end();
+}
+
+void HistoryStore::removeAt(int row)
+{
+    if (row < 0 || row >= _ids.size())
+        return;
+
+    quint32 id = _ids.takeAt(row);
+
+    _elements.removeAt(row);
+    writeRecord(createRecord(RECORD_REMOVE, id));
+
+    // The add and the remove records are both dead
+    _deadRecords += 2;
+    compactIfNeeded();
+}
+
+int HistoryStore::removeOne(const HistoryElement &element)
+{
+    int row = _elements.indexOf(element);
+
+    if (row != -1)
+        removeAt(row);
+
+    return row;
+}
+
+void HistoryStore::clear()
+{
+    _deadRecords += _ids.size() + 1;
+    clearElements();
+    writeRecord(createRecord(RECORD_CLEAR));
+    compactIfNeeded();
+}
+
+QList<HistoryElement> HistoryStore::getElements() const
+{
+    return _elements;
+}
+
+QByteArray HistoryStore::createAddRecord(quint32 id, const HistoryElement &element)
+{
+    return createRecord(RECORD_ADD, id, element);
+}
+
+void HistoryStore::onCompactionFinished()
+{
+    QString compactedFileName = _fileName + HISTORY_COMPACTION_EXTENSION;
+    QFile compactedFile(compactedFileName);
+
+    // Already handled when the store had to wait for the compaction
+    if (!_compactionThread)
+        return;
+
+    _compactionThread->wait();
+    bool succeeded = _compactionThread->hasSucceeded();
+
+    delete _compactionThread;
+    _compactionThread = 0;
+
+    // Records written during the compaction are appended to the compacted file
+    if (succeeded && compactedFile.open(QIODevice::Append))
+    {
+        QDataStream out(&compactedFile);
+
+        foreach (const QByteArray &record, _pendingRecords)
+            out << record;
+
+        succeeded = (out.status() == QDataStream::Ok && compactedFile.flush());
+        compactedFile.close();
+    }
+    else
+    {
+        succeeded = false;
+    }
+
+    if (succeeded)
+    {
+        _file.close();
+        QFile::remove(_fileName);
+        succeeded = QFile::rename(compactedFileName, _fileName);
+        openFile();
+    }
+
+    _compactionSpan.end(succeeded ? QString() : "failed");
+    if (succeeded)
+    {
+        _deadRecords -= _compactedDeadRecords;
+        DEBUG_LOG(LOG_HISTORY, "[History] History file compacted");
+    }
+    else
+    {
+        QFile::remove(compactedFileName);
+        WARNING_LOG(LOG_HISTORY, "[History] History file compaction failed");
+    }
+    _pendingRecords.clear();
+}
+
+void HistoryStore::openFile()
+{
+    if (!_file.isOpen() && !_file.open(QIODevice::WriteOnly | QIODevice::Append))
+        ERROR_LOG(LOG_HISTORY, "[History] Can't open " + _fileName);
+}
+
+void HistoryStore::writeRecord(const QByteArray &record)
+{
+    if (_file.isOpen())
+    {
+        QDataStream out(&_file);
+        QElapsedTimer timer;
+
+        timer.start();
+        out << record;
+        _file.flush();
+        MetricsManager::observe(METRIC_HISTORY_PERSISTENCE, timer.nsecsElapsed() / 1e9);
+    }
+
+    if (_compactionThread)
+        _pendingRecords.append(record);
+}
+
+QByteArray HistoryStore::createRecord(RecordType type, quint32 id, const HistoryElement &element)
+{
+    QByteArray record;
+    QDataStream out(&record, QIODevice::WriteOnly);
+
+    out << (quint8)type;
+    if (type != RECORD_CLEAR)
+        out << id;
+    if (type == RECORD_ADD)
+        out << element;
+
+    return record;
+}
+
+bool HistoryStore::applyRecord(const QByteArray &record, QList<quint32> &ids,
+                               QHash<quint32, HistoryElement> &elements)
+{
+    QDataStream in(record);
+    HistoryElement element;
+    quint8 type;
+    quint32 id = 0;
+
+    in >> type;
+    if (type != RECORD_CLEAR)
+        in >> id;
+
+    switch (type)
+    {
+    case RECORD_ADD:
+        in >> element;
+        if (in.status() != QDataStream::Ok)
+            return false;
+
+        ids.append(id);
+        elements.insert(id, element);
+        _nextId = qMax(_nextId, id + 1);
+        break;
+    case RECORD_REMOVE:
+        elements.remove(id);
+        break;
+    case RECORD_CLEAR:
+        ids.clear();
+        elements.clear();
+        break;
+    default:
+        return false;
+    }
+
+    return (in.status() == QDataStream::Ok);
+}
+
+void HistoryStore::clearElements()
+{
+    _elements.clear();
+    _ids.clear();
+}
+
+void HistoryStore::compactIfNeeded()
+{
+    if (_compactionThread || _deadRecords < HISTORY_COMPACTION_MIN_RECORDS
+            || _deadRecords <= _ids.size())
+        return;
+
+    _compactedDeadRecords = _deadRecords;
+    _compactionSpan.begin("History", "history", "compaction", QString::number(_ids.size()) + " elements");
+    // The lists are implicitly shared, the thread serializes them while the store goes on
+    _compactionThread = new HistoryCompactionThread(_fileName + HISTORY_COMPACTION_EXTENSION, _ids, _elements);
+    connect(_compactionThread, SIGNAL(finished()), this, SLOT(onCompactionFinished()));
+    _compactionThread->start(QThread::LowPriority);
+}
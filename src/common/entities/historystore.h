@@ -0,0 +1,185 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#ifndef HISTORYSTORE_H
+#define HISTORYSTORE_H
+
+#include <QObject>
+#include <QFile>
+#include <QList>
+#include <QHash>
+
+#include "historyelement.h"
+#include "helpers/tracemanager.h"
+
+class HistoryCompactionThread;
+
+/**
+ * @class HistoryStore
+ *
+ * Persistent history of the transfers, without size limit.
+ * Every change is appended to the history file as a record, so adding or
+ * removing an element costs one small write. The file is compacted in the
+ * background once it holds more dead records than live ones.
+ */
+class HistoryStore : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * Constructor
+     *
+     * @param fileName History file
+     * @param parent Parent object
+     */
+    explicit HistoryStore(const QString &fileName, QObject *parent = 0);
+    /**
+     * Destructor, waits for a running compaction
+     */
+    ~HistoryStore();
+
+    /**
+     * Read the history file
+     *
+     * @return True if a history file exists, false otherwise
+     */
+    bool load();
+    /**
+     * Remove the history file
+     */
+    void remove();
+
+    /**
+     * Add an element as the most recent one
+     *
+     * @param element Element to add
+     */
+    void append(const HistoryElement &element);
+    /**
+     * Remove an element
+     *
+     * @param row Row of the element, 0 being the most recent
+     */
+    void removeAt(int row);
+    /**
+     * Remove an element
+     *
+     * @param element Element to remove
+     * @return Row of the removed element, -1 if it was not in the history
+     */
+    int removeOne(const HistoryElement &element);
+    /**
+     * Remove all the elements
+     */
+    void clear();
+
+    /**
+     * Getter : _elements
+     *
+     * @return The elements, most recent first
+     */
+    QList<HistoryElement> getElements() const;
+
+    /**
+     * Serialize the record adding an element
+     *
+     * @param id Record id of the element
+     * @param element Added element
+     * @return The serialized record
+     */
+    static QByteArray createAddRecord(quint32 id, const HistoryElement &element);
+
+private slots:
+    /**
+     * Replace the history file by the compacted one
+     */
+    void onCompactionFinished();
+
+private:
+    /// Record types of the history file
+    enum RecordType {
+        RECORD_ADD = 1,
+        RECORD_REMOVE,
+        RECORD_CLEAR
+    };
+
+    /// History file name
+    QString _fileName;
+    /// History file, opened in append mode
+    QFile _file;
+    /// Elements, most recent first
+    QList<HistoryElement> _elements;
+    /// Record id of each element, same order as _elements
+    QList<quint32> _ids;
+    /// Id of the next added element
+    quint32 _nextId;
+    /// Records of the file which do not describe a live element
+    int _deadRecords;
+    /// Dead records of the file when the running compaction started
+    int _compactedDeadRecords;
+    /// Running compaction, 0 if none
+    HistoryCompactionThread *_compactionThread;
+    /// Records written since the running compaction started
+    QList<QByteArray> _pendingRecords;
+    /// Trace of the running compaction
+    TraceSpan _compactionSpan;
+
+    /**
+     * Open the history file for appending records
+     */
+    void openFile();
+    /**
+     * Append a record to the history file
+     *
+     * @param record Serialized record
+     */
+    void writeRecord(const QByteArray &record);
+    /**
+     * Serialize a record
+     *
+     * @param type Type of the record
+     * @param id Record id of the element
+     * @param element Added element, for RECORD_ADD only
+     * @return The serialized record
+     */
+    static QByteArray createRecord(RecordType type, quint32 id = 0,
+                                   const HistoryElement &element = HistoryElement());
+    /**
+     * Apply a record read from the history file
+     * The elements are only ordered once the whole file is read
+     *
+     * @param record Serialized record
+     * @param ids Record ids of the added elements, oldest first
+     * @param elements Live elements by record id
+     * @return False if the record is corrupted, true otherwise
+     */
+    bool applyRecord(const QByteArray &record, QList<quint32> &ids,
+                     QHash<quint32, HistoryElement> &elements);
+    /**
+     * Empty the list of the elements
+     */
+    void clearElements();
+    /**
+     * Start a compaction if the file holds too many dead records
+     */
+    void compactIfNeeded();
+};
+
+#endif // HISTORYSTORE_H
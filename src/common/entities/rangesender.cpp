@@ -0,0 +1,103 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#include "rangesender.h"
+#include "helpers/logmanager.h"
+#include "appconfig.h"
+
+RangeSender::RangeSender(const QString &filePath, qint64 offset, qint64 length, qint64 highWatermark, QObject *parent) :
+    QObject(parent),
+    _socket(this),
+    _file(filePath),
+    _offset(offset),
+    _length(length),
+    _position(offset),
+    _highWatermark(highWatermark),
+    _pump(READ_FILE_BUFFER)
+{
+    _socket.setSocketOption(QAbstractSocket::LowDelayOption, 1);
+
+    connect(&_socket, SIGNAL(connected()), this, SLOT(onConnected()));
+    connect(&_socket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(socketError(QAbstractSocket::SocketError)));
+}
+
+RangeSender::~RangeSender()
+{
+    abort();
+}
+
+void RangeSender::start(const QHostAddress &address, int port, const QByteArray &header)
+{
+    _header = header;
+
+    if (!_file.open(QIODevice::ReadOnly) || !_file.seek(_offset))
+    {
+        ERROR_LOG(LOG_TRANSFER, "[Server] ERROR - Cannot open range of " + _file.fileName());
+        emit failed(this);
+
+        return;
+    }
+
+    _socket.connectToHost(address, port, QIODevice::ReadWrite);
+}
+
+void RangeSender::abort()
+{
+    disconnect(&_socket, 0, this, 0);
+    _socket.abort();
+
+    if (_file.isOpen())
+        _file.close();
+}
+
+void RangeSender::onConnected()
+{
+    connect(&_socket, SIGNAL(bytesWritten(qint64)), this, SLOT(onBytesWritten(qint64)));
+    _socket.write(_header);
+}
+
+void RangeSender::onBytesWritten(qint64)
+{
+    SendPump::Status status = _pump.pump(&_file, &_socket, _position, _offset + _length, _highWatermark);
+
+    if (status == SendPump::Failed)
+    {
+        ERROR_LOG(LOG_TRANSFER, "[Server] ERROR - Cannot read range of " + _file.fileName());
+        emit failed(this);
+
+        return;
+    }
+
+    // Leave once the whole range is written and the socket buffer drained
+    if (status == SendPump::Waiting || _socket.bytesToWrite() > 0)
+        return;
+
+    disconnect(&_socket, 0, this, 0);
+    _file.close();
+    _socket.disconnectFromHost();
+    emit finished(this);
+}
+
+void RangeSender::socketError(QAbstractSocket::SocketError)
+{
+    ERROR_LOG(LOG_TRANSFER, "[Server] Stream ERROR - " + _socket.errorString());
+
+    emit failed(this);
+}
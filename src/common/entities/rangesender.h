@@ -0,0 +1,113 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#ifndef RANGESENDER_H
+#define RANGESENDER_H
+
+#include <QObject>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QFile>
+#include <QByteArray>
+
+#include "helpers/sendpump.h"
+
+/**
+  * @class RangeSender
+  *
+  * Extra connection of a multi-stream transfer.
+  * Sends a byte range of the current file of a Device through its own socket,
+  * the receiver writes the range at its offset in the destination file.
+  */
+class RangeSender : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+      * Constructor
+      *
+      * @param filePath File to send
+      * @param offset First byte of the range
+      * @param length Number of bytes of the range
+      * @param highWatermark Bytes of the range that may be queued in the socket
+      */
+    RangeSender(const QString &filePath, qint64 offset, qint64 length, qint64 highWatermark, QObject *parent = 0);
+    /**
+      * Destructor
+      */
+    ~RangeSender();
+
+    /**
+      * Connect to the receiver, send the range header then the range content
+      *
+      * @param address Address of the receiver
+      * @param port Port of the receiver
+      * @param header Connection header identifying the transfer and the range
+      */
+    void start(const QHostAddress &address, int port, const QByteArray &header);
+    /**
+      * Stop sending the range and close the connection
+      */
+    void abort();
+
+signals:
+    /**
+      * The whole range has been written
+      */
+    void finished(RangeSender *sender);
+    /**
+      * The range cannot be sent
+      */
+    void failed(RangeSender *sender);
+
+private slots:
+    /**
+      * SLOT : Send the header and start streaming the range
+      */
+    void onConnected();
+    /**
+      * SLOT : Send the next part of the range
+      */
+    void onBytesWritten(qint64 bytes);
+    /**
+      * SLOT : Socket error
+      */
+    void socketError(QAbstractSocket::SocketError error);
+
+private:
+    /// Connection to the receiver
+    QTcpSocket _socket;
+    /// File being sent
+    QFile _file;
+    /// Header sent once connected
+    QByteArray _header;
+    /// First byte of the range
+    qint64 _offset;
+    /// Number of bytes of the range
+    qint64 _length;
+    /// Position of the next byte of the range to send
+    qint64 _position;
+    /// Bytes that may be queued in the socket, reading resumes below half of it
+    qint64 _highWatermark;
+    /// Sends the range
+    SendPump _pump;
+};
+
+#endif // RANGESENDER_H
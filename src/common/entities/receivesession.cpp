@@ -0,0 +1,850 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#include <QDataStream>
+#include <QApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QtEndian>
+
+#include "receivesession.h"
+#include "service.h"
+#include "helpers/logmanager.h"
+#include "helpers/metricsmanager.h"
+#include "helpers/filehelper.h"
+#include "helpers/settingsmanager.h"
+#include "helpers/folderextractor.h"
+#include "helpers/resumejournal.h"
+#include "threads/clipboardthreadevent.h"
+#include "config/appconfig.h"
+
+ReceiveSession::ReceiveSession(QTcpSocket *socket, Service *service) :
+    _socket(socket),
+    _service(service),
+    _bDataSize(false),
+    _bDataType(false),
+    _dataSize(0),
+    _fileSize(0),
+    _bUid(false),
+    _bName(false),
+    _bType(false),
+    _bFileSize(false),
+    _bFilename(false),
+    _dataType(0),
+    _progressCounter(0),
+    _bFeatures(false),
+    _features(0),
+    _bFileDate(false),
+    _fileDate(0),
+    _resumeOffset(0),
+    _journalOffset(0),
+    _bytesReceived(0),
+    _rangeEnd(0),
+    _streamBytes(0),
+    _pendingStreams(0),
+    _bRange(false),
+    _extractor(0),
+    _fastReceive(SettingsManager::isFastReceiveEnabled()),
+    _finished(false),
+    _admitted(false),
+    _idleTimer(this)
+{
+    _socket->setParent(this);
+
+    _idleTimer.setSingleShot(true);
+    connect(&_idleTimer, SIGNAL(timeout()), this, SLOT(onSessionIdle()));
+
+    connect(_socket, SIGNAL(readyRead()),
+            this, SLOT(onDataReceived()));
+    connect(_socket, SIGNAL(disconnected()),
+            this, SLOT(onDeviceDisconnected()));
+    connect(_socket, SIGNAL(error(QAbstractSocket::SocketError)),
+            this, SLOT(socketError(QAbstractSocket::SocketError)));
+}
+
+ReceiveSession::~ReceiveSession()
+{
+    if (_file.isOpen())
+        _file.close();
+    delete _extractor;
+}
+
+QTcpSocket *ReceiveSession::getSocket() const
+{
+    return _socket;
+}
+
+bool ReceiveSession::isReceivingFile() const
+{
+    return (_bDataType && DataStruct::isFileType(DataType(_dataType)) && _bFilename);
+}
+
+bool ReceiveSession::isReceiving(const HistoryElement &element)
+{
+    return (isReceivingFile() && _currentHistoryElement == element);
+}
+
+bool ReceiveSession::isAdmitted() const
+{
+    return _admitted;
+}
+
+bool ReceiveSession::isIdle() const
+{
+    return _idleTimer.isActive();
+}
+
+void ReceiveSession::onSessionIdle()
+{
+    DEBUG_LOG(LOG_CONNECTION, "[Service] Closing the idle session (IP - " + _socket->peerAddress().toString() + ")");
+    finish();
+}
+
+void ReceiveSession::finish()
+{
+    _idleTimer.stop();
+    // The track is named after the peer port, it is not used again once the socket is closed
+    if (!_finished)
+        TraceManager::releaseTrack(getTraceTrack());
+    if (_file.isOpen())
+        _file.close();
+    if (_extractor)
+    {
+        delete _extractor;
+        _extractor = 0;
+    }
+    _socket->close();
+
+    if (!_finished)
+    {
+        _finished = true;
+        emit finished(this);
+    }
+}
+
+void ReceiveSession::socketError(QAbstractSocket::SocketError)
+{
+    ERROR_LOG(LOG_CONNECTION, "[Service] Socket ERROR - " + _socket->errorString() + " (IP - " + _socket->peerName() + ")");
+
+    interruptTransfer(_features & FEATURE_RESUME);
+}
+
+void ReceiveSession::deleteFileReset()
+{
+    interruptTransfer(false);
+}
+
+void ReceiveSession::interruptTransfer(bool keepPartialFile)
+{
+    if (_finished)
+        return;
+
+    if (isReceivingFile()) {
+        removeCurrentFile(keepPartialFile);
+    }
+
+    if (_streamOwner)
+    {
+        ReceiveSession *owner = _streamOwner;
+
+        _streamOwner = 0;
+        owner->onStreamFinished(false);
+    }
+
+    finish();
+}
+
+void ReceiveSession::onDeviceDisconnected()
+{
+    _socket->abort();
+    _socket->close();
+
+    if (!_finished)
+        interruptTransfer(_features & FEATURE_RESUME);
+}
+
+void ReceiveSession::onDataReceived()
+{
+    QDataStream stream(_socket);
+
+    _idleTimer.stop();
+
+    do
+    {
+        if (!_bUid)
+        {
+            if (_socket->bytesAvailable() < sizeof(unsigned))
+                return;
+            stream >> _dataUid;
+            _bUid = true;
+        }
+        if (!_bName)
+        {
+            if (_socket->bytesAvailable() < sizeof(unsigned))
+                return;
+            stream >> _dataName;
+            _bName = true;
+        }
+        if (!_bType)
+        {
+            if (_socket->bytesAvailable() < sizeof(unsigned))
+                return;
+            stream >> _serverType;
+            _bType = true;
+        }
+        while (!_bDataType)
+        {
+            if (_socket->bytesAvailable() < sizeof(unsigned))
+                return;
+            if (_bFeatures)
+            {
+                // Features acknowledged by the sender, the data type follows
+                stream >> _features;
+                _features &= PROTOCOL_FEATURES;
+                _bFeatures = false;
+            }
+            else
+            {
+                stream >> _dataType;
+                if (_dataType == TYPE_FEATURES)
+                    _bFeatures = true;
+                else
+                    _bDataType = true;
+            }
+        }
+        if (!_bDataSize)
+        {
+            if (_socket->bytesAvailable() < sizeof(unsigned))
+                return;
+            stream >> _dataSize;
+            _bDataSize = true;
+        }
+
+        // Transfers wait for a slot that is not reserved for the streams of another file
+        if (_dataType != TYPE_STREAM_RANGE && !_admitted)
+        {
+            if (!_service->admitTransfer(this))
+                return;
+            _admitted = true;
+        }
+
+        if (_dataType == TYPE_STREAM_RANGE)
+        {
+            if (readStreamRange())
+                finish();
+            return;
+        }
+
+        if (DataStruct::isFileType(DataType(_dataType)))
+        {
+            if (!readFiles())
+                return;
+        }
+        else
+        {
+            if (!readText())
+                return;
+        }
+
+        if (_features & FEATURE_SESSION && !_finished)
+        {
+            // Persistent session, the next transfer starts with its data type
+            _bDataType = false;
+            _bDataSize = false;
+        }
+
+    } while(_socket->bytesAvailable() > 2);
+
+    if (_features & FEATURE_SESSION && !_finished)
+    {
+        // Wait for the next transfer of the sender
+        _idleTimer.start(SESSION_RECEIVE_TIMEOUT);
+        return;
+    }
+
+    finish();
+}
+
+void ReceiveSession::sendACK()
+{
+    if (_socket->isOpen())
+    {
+        QByteArray data;
+        QDataStream stream(&data, QIODevice::WriteOnly);
+
+        TRACE_LOG(LOG_TRANSFER, "[Service] Data received, sending ACK");
+
+        // Data type
+        stream << (unsigned)TYPE_ACK;
+
+        _socket->write(data);
+    }
+}
+
+void ReceiveSession::sendMessage(MessageType type, const QString &message)
+{
+    if (_socket->isOpen())
+    {
+        QByteArray data;
+        QDataStream stream(&data, QIODevice::WriteOnly);
+
+        TRACE_LOG(LOG_TRANSFER, "[Service] Send message : " + message);
+
+        // Data type
+        stream << (unsigned)TYPE_MESSAGE;
+        // Message type
+        stream << (unsigned)type;
+        // Message
+        stream << message;
+
+        _socket->write(data);
+    }
+}
+
+void ReceiveSession::sendProgress(unsigned percentage)
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+
+    stream << (unsigned)TYPE_DOWNLOAD_PROGRESS;
+    _socket->write(data);
+
+    data.clear();
+    stream.skipRawData(4);
+
+    stream << (unsigned)percentage;
+    _socket->write(data);
+}
+
+bool ReceiveSession::readFiles()
+{
+    while (readFile())
+    {
+        // Here _dataSize is the number of files
+        if (_finished || --_dataSize <= 0)
+            return true;
+    }
+
+    return false;
+}
+
+bool ReceiveSession::readFile()
+{
+    QDataStream stream(_socket);
+
+    if (_socket->isOpen())
+    {
+        if (!_bFileSize)
+        {
+            if (_socket->bytesAvailable() < sizeof(qint64))
+                return false;
+            stream >> _fileSize;
+            _rangeEnd = _fileSize;
+            _bFileSize = true;
+        }
+
+        if (!_bFilename)
+        {
+            if (!isStringAvailable())
+                return false;
+            stream >> _filename;
+            _bFilename = true;
+
+            if (_filename.contains(ZIP_EXTENSION)) {
+                QString noExtension = _filename;
+                noExtension.remove(ZIP_EXTENSION);
+                _currentHistoryElement = HistoryElement(QDateTime::currentDateTime(), noExtension, _dataName, _fileSize, HISTORY_FOLDER_TYPE);
+                emit receivingFolder(noExtension, _fileSize);
+            } else {
+                _currentHistoryElement = HistoryElement(QDateTime::currentDateTime(), _filename, _dataName, _fileSize, HISTORY_FILE_TYPE);
+                emit receivingFile(_filename, _fileSize);
+            }
+            _service->addElementToHistory(_currentHistoryElement);
+            _fileSpan.begin(getTraceTrack(), "transfer", "receive", _filename);
+        }
+
+        bool streamHandshake = DataStruct::hasStreamHandshake(_features, _fileSize);
+
+        if (!_bFileDate && (streamHandshake || DataStruct::hasResumeHandshake(_features, _fileSize)))
+        {
+            qint64 needed = (_features & FEATURE_RESUME) ? sizeof(qint64) : 0;
+
+            if (streamHandshake)
+                needed += sizeof(unsigned);
+            if (_socket->bytesAvailable() < needed)
+                return false;
+
+            if (_features & FEATURE_RESUME)
+                stream >> _fileDate;
+            _bFileDate = true;
+
+            if (streamHandshake)
+            {
+                unsigned requested;
+
+                stream >> requested;
+                negotiateStreams(requested);
+            }
+            else
+            {
+                // Folders are extracted on the fly, there is no archive to resume
+                if (!isFolder())
+                    _resumeOffset = ResumeJournal::getResumeOffset(getFilePath(), _dataUid, _fileSize, _fileDate);
+                sendResumeOffset(_resumeOffset);
+            }
+        }
+
+        if(isOutputOpen() && _fileSize != 0
+                && (_socket->bytesAvailable() + _bytesReceived) < _rangeEnd
+                && (_socket->bytesAvailable() + _bytesReceived) < NOTIFY_FACTOR)
+            return false;
+
+        if (!isOutputOpen() && !openOutput())
+        {
+            ERROR_LOG(LOG_TRANSFER, "[Service] File ERROR - Can't create the file");
+            emit cannotCreateFile();
+            removeCurrentFile();
+            finish();
+            return true;
+        }
+
+        if (!writeSocketContent())
+        {
+            ERROR_LOG(LOG_TRANSFER, "[Service] File ERROR - Can't write " + _filename);
+            emit cannotCreateFile();
+            removeCurrentFile();
+            finish();
+            return true;
+        }
+
+        updateProgress();
+
+        // Ranges received by other connections cannot be journaled
+        if (_features & FEATURE_RESUME && !_extractor && _rangeEnd == _fileSize
+                && _bytesReceived - _journalOffset >= RESUME_JOURNAL_INTERVAL)
+            saveJournal();
+
+        if (_bytesReceived < _rangeEnd || _pendingStreams > 0)
+            return false;
+
+        if (_extractor)
+        {
+            // The archive ended in the middle of an entry
+            if (!_extractor->isComplete())
+            {
+                ERROR_LOG(LOG_TRANSFER, "[Service] Folder ERROR - " + _filename + " is truncated");
+                sendMessage(MESSAGE_POPUP, tr("The folder %1 was not entirely received").arg(QString(_filename).remove(ZIP_EXTENSION)));
+                removeCurrentFile();
+                finish();
+                return true;
+            }
+
+            delete _extractor;
+            _extractor = 0;
+            _extractSpan.end();
+            _filename.remove(ZIP_EXTENSION);
+            INFO_LOG(LOG_TRANSFER, "[Service] [FOLDER] " + _filename + " extracted");
+        }
+        else
+        {
+            _file.close();
+            ResumeJournal::remove(_file.fileName());
+            INFO_LOG(LOG_TRANSFER, "[Service] [FILE] " + _filename + " written");
+        }
+
+        _fileSpan.end();
+        emit historyElementProgressUpdated(_currentHistoryElement, 100);
+
+        if (_dataType == TYPE_FILE_OPEN && SettingsManager::isAutoOpenFilesEnabled())
+        {
+            QFileInfo fileInfo(SettingsManager::getDestinationFolder() + "/" + _filename);
+            FileHelper::openURL("file:///" + fileInfo.absoluteFilePath());
+        }
+
+        _bFileSize = false;
+        _bFilename = false;
+        _bFileDate = false;
+        _resumeOffset = 0;
+        _journalOffset = 0;
+        _bytesReceived = 0;
+        _rangeEnd = 0;
+        _streamBytes = 0;
+        _progressCounter = 0;
+        _socketContent.clear();
+        _service->releaseStreams(this);
+
+        sendACK();
+    }
+
+    return true;
+}
+
+void ReceiveSession::updateProgress()
+{
+    qint64 received = _bytesReceived + _streamBytes;
+
+    if (received > (qint64)NOTIFY_FACTOR * _progressCounter)
+    {
+        unsigned progress = (received * 100) / _fileSize;
+        sendProgress(progress);
+        emit historyElementProgressUpdated(_currentHistoryElement, progress);
+        ++_progressCounter;
+    }
+}
+
+void ReceiveSession::negotiateStreams(unsigned requested)
+{
+    quint32 token = 0;
+    unsigned accepted = 1;
+
+    // Folders are extracted sequentially, they cannot be split in ranges
+    if (!isFolder() && requested > 1)
+        accepted = _service->reserveStreams(this, requested, token);
+
+    if (accepted > 1)
+    {
+        _rangeEnd = _fileSize / accepted;
+        _pendingStreams = accepted - 1;
+
+        // Ranges are written in place, the file has to exist before the extra connections arrive
+        if (!openOutput())
+        {
+            _service->releaseStreams(this);
+            _rangeEnd = _fileSize;
+            _pendingStreams = 0;
+            accepted = 1;
+            token = 0;
+        }
+        else
+            INFO_LOG(LOG_TRANSFER, "[Service] Receiving " + _filename + " on " + QString::number(accepted) + " streams");
+    }
+    else if (_features & FEATURE_RESUME && !isFolder())
+        _resumeOffset = ResumeJournal::getResumeOffset(getFilePath(), _dataUid, _fileSize, _fileDate);
+
+    sendStreamCount(accepted, token, _resumeOffset);
+}
+
+bool ReceiveSession::acceptsRange(const QString &uid, qint64 offset, qint64 length) const
+{
+    return (isReceivingFile() && _pendingStreams > 0 && uid == _dataUid
+            && offset >= _rangeEnd && length > 0 && offset + length <= _fileSize);
+}
+
+void ReceiveSession::onStreamData(qint64 bytes)
+{
+    _streamBytes += bytes;
+    updateProgress();
+}
+
+void ReceiveSession::onStreamFinished(bool success)
+{
+    if (!success)
+    {
+        ERROR_LOG(LOG_TRANSFER, "[Service] Stream ERROR - " + _filename + " is incomplete");
+        interruptTransfer(false);
+        return;
+    }
+
+    // The first range may already be complete
+    if (_pendingStreams > 0 && --_pendingStreams == 0)
+        onDataReceived();
+}
+
+bool ReceiveSession::readStreamRange()
+{
+    if (!_bRange)
+    {
+        QDataStream stream(_socket);
+        quint32 token;
+        qint64 offset;
+
+        if (_socket->bytesAvailable() < sizeof(quint32) + 2 * sizeof(qint64))
+            return false;
+
+        stream >> token >> offset >> _fileSize;
+        _rangeEnd = _fileSize;
+        _bRange = true;
+        _streamOwner = _service->claimStream(token);
+
+        if (!_streamOwner || !_streamOwner->acceptsRange(_dataUid, offset, _fileSize))
+        {
+            ERROR_LOG(LOG_TRANSFER, "[Service] Stream ERROR - Unexpected range (IP - " + _socket->peerAddress().toString() + ")");
+            interruptTransfer(false);
+            return false;
+        }
+        _admitted = true;
+
+        QIODevice::OpenMode mode = QIODevice::ReadWrite;
+        if (_fastReceive)
+            mode |= QIODevice::Unbuffered;
+
+        _file.setFileName(_streamOwner->getFilePath());
+        if (!_file.open(mode) || !_file.seek(offset))
+        {
+            ERROR_LOG(LOG_TRANSFER, "[Service] Stream ERROR - Can't open " + _file.fileName());
+            interruptTransfer(false);
+            return false;
+        }
+    }
+
+    if (!_streamOwner)
+        return true;
+
+    qint64 received = _bytesReceived;
+
+    if (!writeSocketContent())
+    {
+        ERROR_LOG(LOG_TRANSFER, "[Service] Stream ERROR - Can't write " + _file.fileName());
+        interruptTransfer(false);
+        return false;
+    }
+
+    _streamOwner->onStreamData(_bytesReceived - received);
+
+    if (_bytesReceived < _fileSize)
+        return false;
+
+    ReceiveSession *owner = _streamOwner;
+
+    _file.close();
+    _streamOwner = 0;
+    owner->onStreamFinished(true);
+
+    return true;
+}
+
+bool ReceiveSession::isStringAvailable() const
+{
+    quint32 size;
+
+    if (_socket->peek(reinterpret_cast<char *>(&size), sizeof(size)) < (qint64)sizeof(size))
+        return false;
+
+    size = qFromBigEndian(size);
+
+    return (size == 0xFFFFFFFF || _socket->bytesAvailable() >= sizeof(size) + size);
+}
+
+bool ReceiveSession::isFolder() const
+{
+    return _filename.endsWith(ZIP_EXTENSION);
+}
+
+bool ReceiveSession::isOutputOpen() const
+{
+    return (_extractor || _file.isOpen());
+}
+
+bool ReceiveSession::openOutput()
+{
+    QDir receptionDir;
+    int notifyFactor = NOTIFY_FACTOR;
+
+    receptionDir.mkpath(SettingsManager::getDestinationFolder());
+
+    if (isFolder())
+    {
+        QString folderPath = getFilePath();
+
+        folderPath.remove(ZIP_EXTENSION);
+        INFO_LOG(LOG_TRANSFER, "[Service] Extracting directory (" + folderPath + ")");
+        _extractSpan.begin(getTraceTrack(), "transfer", "extract", _filename);
+        _extractor = new FolderExtractor(folderPath);
+
+        return _extractor->open();
+    }
+
+    QIODevice::OpenMode mode = (_resumeOffset > 0) ? QIODevice::ReadWrite
+                                                   : QIODevice::WriteOnly | QIODevice::Truncate;
+    if (_fastReceive)
+        mode |= QIODevice::Unbuffered;
+
+    _file.setFileName(getFilePath());
+    if (!_file.open(mode))
+        return false;
+
+    if (_resumeOffset > 0)
+    {
+        INFO_LOG(LOG_TRANSFER, "[Service] Resuming " + _filename + " at " + QString::number(_resumeOffset));
+        _file.resize(_resumeOffset);
+        _file.seek(_resumeOffset);
+        _bytesReceived = _resumeOffset;
+        _progressCounter = _resumeOffset / notifyFactor;
+        _journalOffset = _resumeOffset;
+    }
+
+    if (_fastReceive)
+        FileHelper::preallocate(_file, _fileSize);
+
+    return true;
+}
+
+bool ReceiveSession::writeSocketContent()
+{
+    qint64 remaining = _rangeEnd - _bytesReceived;
+
+    if (!_fastReceive && !_extractor)
+    {
+        _socketContent = _socket->read(qMin(remaining, _socket->bytesAvailable()));
+        _bytesReceived += _socketContent.size();
+        MetricsManager::increment(METRIC_BYTES_RECEIVED, _socketContent.size());
+
+        return (_file.write(_socketContent) == _socketContent.size());
+    }
+
+    if (_receiveBuffer.isEmpty())
+        _receiveBuffer.resize(RECEIVE_FILE_BUFFER);
+
+    while (remaining > 0 && _socket->bytesAvailable() > 0)
+    {
+        qint64 read = _socket->read(_receiveBuffer.data(), qMin(remaining, (qint64)_receiveBuffer.size()));
+
+        if (read <= 0)
+            break;
+
+        if (_extractor)
+        {
+            if (!_extractor->write(_receiveBuffer.constData(), read))
+                return false;
+        }
+        else if (_file.write(_receiveBuffer.constData(), read) != read)
+            return false;
+
+        _bytesReceived += read;
+        remaining -= read;
+        MetricsManager::increment(METRIC_BYTES_RECEIVED, read);
+    }
+
+    return true;
+}
+
+void ReceiveSession::removeCurrentFile(bool keepPartialFile)
+{
+    _fileSpan.end("failed");
+    _extractSpan.end("failed");
+    _service->removeElementFromHistory(_currentHistoryElement);
+    if (_extractor)
+    {
+        _extractor->abort();
+        delete _extractor;
+        _extractor = 0;
+    }
+    if (_file.isOpen())
+    {
+        if (keepPartialFile && _rangeEnd == _fileSize && _bytesReceived < _fileSize)
+        {
+            saveJournal();
+            _file.close();
+            INFO_LOG(LOG_TRANSFER, "[Service] " + _filename + " kept for resume (" + QString::number(_journalOffset) + " bytes)");
+            return;
+        }
+
+        _file.close();
+        // Ranges written in place may have given the file its final size already
+        if (_file.size() < _fileSize || _pendingStreams > 0)
+        {
+            FileHelper::deleteFileFromDisk(_file);
+            ResumeJournal::remove(_file.fileName());
+        }
+    }
+}
+
+void ReceiveSession::saveJournal()
+{
+    // Only what reached the disk can be announced as resumable
+    _file.flush();
+    if (ResumeJournal::save(_file.fileName(), _dataUid, _fileSize, _fileDate, _bytesReceived))
+        _journalOffset = _bytesReceived;
+}
+
+QString ReceiveSession::getFilePath() const
+{
+    return SettingsManager::getDestinationFolder() + "/" + _filename;
+}
+
+void ReceiveSession::sendStreamCount(unsigned streams, quint32 token, qint64 offset)
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+
+    // Data type
+    stream << (unsigned)TYPE_STREAM_COUNT;
+    // Accepted connections and token of the extra ones
+    stream << streams << token;
+    // Offset from which the file should be sent
+    stream << offset;
+
+    _socket->write(data);
+}
+
+void ReceiveSession::sendResumeOffset(qint64 offset)
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+
+    // Data type
+    stream << (unsigned)TYPE_RESUME_OFFSET;
+    // Offset from which the file should be sent
+    stream << offset;
+
+    _socket->write(data);
+}
+
+bool ReceiveSession::readText()
+{
+    QDataStream stream(_socket);
+    QString text;
+
+    if(_socket->bytesAvailable() < _dataSize)
+        return false;
+
+    stream >> text;
+
+    // Notify the controller for a clipboard save
+    QApplication::postEvent(_service->getController(), new ClipboardThreadEvent(text));
+
+    if (_dataType == TYPE_URL_OPEN)
+    {
+        emit receivingUrl(text);
+        INFO_LOG(LOG_TRANSFER, "[Service] [URL] '" + text + "' opened");
+        if (SettingsManager::isAutoOpenFilesEnabled())
+            FileHelper::openURL(text);
+
+        _currentHistoryElement = HistoryElement(QDateTime::currentDateTime(), text, _dataName, _dataSize, HISTORY_URL_TYPE);
+    }
+    else
+    {
+        emit receivingText(text);
+        INFO_LOG(LOG_TRANSFER, "[Service] [TEXT] '" + text + "' saved into clipboard");
+
+        _currentHistoryElement = HistoryElement(QDateTime::currentDateTime(), text, _dataName, _dataSize, HISTORY_TEXT_TYPE);
+    }
+
+    _service->addElementToHistory(_currentHistoryElement);
+
+    sendACK();
+
+    return true;
+}
+
+QString ReceiveSession::getTraceTrack() const
+{
+    return "Session " + _socket->peerAddress().toString() + ":" + QString::number(_socket->peerPort());
+}
@@ -0,0 +1,377 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#ifndef RECEIVESESSION_H
+#define RECEIVESESSION_H
+
+#include <QObject>
+#include <QTcpSocket>
+#include <QFile>
+#include <QPointer>
+#include <QTimer>
+
+#include "historyelement.h"
+#include "datastruct.h"
+#include "device.h"
+#include "helpers/folderextractor.h"
+#include "helpers/tracemanager.h"
+
+class Service;
+
+/**
+  * @class ReceiveSession
+  *
+  * Incoming connection handled by the service.
+  * Each session owns its socket, its parser state, the file being written
+  * and the corresponding history element, so several transfers can run at once.
+  */
+class ReceiveSession : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+      * Constructor
+      *
+      * @param socket Accepted socket, the session takes its ownership
+      * @param service Service owning the session (history, controller)
+      */
+    ReceiveSession(QTcpSocket *socket, Service *service);
+    /**
+      * Destructor
+      */
+    ~ReceiveSession();
+
+    /**
+      * Read the files sent by the server
+      * Pipelined senders do not wait for the ACK, so several files may already be buffered
+      *
+      * @return True if all the files are read, false else
+      */
+    bool readFiles();
+    /**
+      * Read a file sent by the server
+      *
+      * @return True if the file is fully read, false else
+      */
+    bool readFile();
+    /**
+      * Read a text sent by the server
+      *
+      * @return True if the text is fully read, false else
+      */
+    bool readText();
+    /**
+      * Send ACK to the server
+      */
+    void sendACK();
+    /**
+     * Send the progress of the download
+     *
+     * @param percentage Progress in percent
+     */
+    void sendProgress(unsigned percentage);
+    /**
+     * Send message to the session socket
+     *
+     * @param type Message type, overlay or popup
+     * @param message Message to send
+     */
+    void sendMessage(MessageType type, const QString &message);
+    /**
+     * Send the offset from which the current file should be sent
+     *
+     * @param offset Number of bytes already received in a previous transfer
+     */
+    void sendResumeOffset(qint64 offset);
+    /**
+     * Send the number of connections accepted for the current file
+     *
+     * @param streams Number of connections, 1 for a single stream transfer
+     * @param token Token the extra connections have to present
+     * @param offset Offset from which the file should be sent
+     */
+    void sendStreamCount(unsigned streams, quint32 token, qint64 offset);
+    /**
+     * On error, remove the current file if it is not properly written
+     *
+     * @param keepPartialFile Keep the partial file and its journal to resume it later
+     */
+    void removeCurrentFile(bool keepPartialFile = false);
+    /**
+     * Tells if the session is currently receiving a file
+     */
+    bool isReceivingFile() const;
+    /**
+     * Tells if the session is currently receiving the file of an history element
+     *
+     * @param element History element of the file
+     */
+    bool isReceiving(const HistoryElement &element);
+    /**
+     * Tells if the session is kept open between two transfers of the sender
+     */
+    bool isIdle() const;
+    /**
+     * Tells if the session occupies one of the MaxSessions slots, as a transfer or as a claimed stream
+     */
+    bool isAdmitted() const;
+    /**
+     * Getter : _socket
+     */
+    QTcpSocket *getSocket() const;
+    /**
+     * Path of the current file in the destination folder
+     */
+    QString getFilePath() const;
+    /**
+     * Tells if an extra connection may write a range of the current file
+     *
+     * @param uid Uid of the sender of the extra connection
+     * @param offset First byte of the range
+     * @param length Number of bytes of the range
+     */
+    bool acceptsRange(const QString &uid, qint64 offset, qint64 length) const;
+    /**
+     * An extra connection wrote bytes of the current file
+     *
+     * @param bytes Number of bytes written
+     */
+    void onStreamData(qint64 bytes);
+    /**
+     * An extra connection ended
+     *
+     * @param success True if the whole range has been written
+     */
+    void onStreamFinished(bool success);
+
+public slots:
+    /**
+      * SLOT : On data received (File or text)
+      */
+    void onDataReceived();
+    /**
+      * SLOT : On device disconnected
+      */
+    void onDeviceDisconnected();
+    /**
+      * On socket error
+      */
+    void socketError(QAbstractSocket::SocketError);
+    /**
+     * Interrupt the current download, delete the file, change history
+     */
+    void deleteFileReset();
+    /**
+     * Close the session, the sender did not use it for SESSION_RECEIVE_TIMEOUT ms
+     */
+    void onSessionIdle();
+
+signals:
+    /**
+     * Notify that the session is over and can be deleted
+     *
+     * @param session The ended session
+     */
+    void finished(ReceiveSession *session);
+    /**
+     * Notify the view of the download progress
+     *
+     * @param element History element being downloaded
+     * @param progress Download progress percentage
+     */
+    void historyElementProgressUpdated(const HistoryElement &element, unsigned progress);
+    /**
+     * Notify that the file cannot be created
+     */
+    void cannotCreateFile();
+    /**
+     * Notify that a file is about to be received
+     *
+     * @param fileName The name of the file
+     * @param fileSize The size of the file
+     */
+    void receivingFile(const QString &fileName, int fileSize);
+    /**
+     * Notify that a folder is about to be received
+     *
+     * @param folderName The name of the folder
+     * @param folderSize The size of the folder
+     */
+    void receivingFolder(const QString &folderName, int folderSize);
+    /**
+     * Notify that a text is received
+     *
+     * @param text The text received
+     */
+    void receivingText(const QString &text);
+    /**
+     * Notify that a url is received
+     *
+     * @param text The url received
+     */
+    void receivingUrl(const QString &text);
+
+private:
+    /// Socket of the session
+    QTcpSocket *_socket;
+    /// Service owning the session
+    Service *_service;
+    /// Boolean for the data size reception
+    bool _bDataSize;
+    /// Boolean for the data tye reception
+    bool _bDataType;
+    /// Size of the data to read on the socket
+    unsigned _dataSize;
+    /// Size of the file
+    qint64 _fileSize;
+    /// Uid of the server
+    QString _dataUid;
+    /// Name of the server
+    QString _dataName;
+    /// Type of the server
+    QString _serverType;
+    /// Boolean for the uid
+    bool _bUid;
+    /// Boolean for the name
+    bool _bName;
+    /// Boolean for the type
+    bool _bType;
+    /// Boolean for the file size
+    bool _bFileSize;
+    /// Boolean for file name reception
+    bool _bFilename;
+    /// Type of the data
+    unsigned _dataType;
+    /// Boolean for the features mask reception
+    bool _bFeatures;
+    /// Features acknowledged by the sender
+    unsigned _features;
+    /// Boolean for the file date reception (resume feature)
+    bool _bFileDate;
+    /// Modification date of the file on the sender (resume feature)
+    qint64 _fileDate;
+    /// Offset from which the current file is resumed
+    qint64 _resumeOffset;
+    /// Offset written in the resume journal
+    qint64 _journalOffset;
+    /// Bytes of the current file received (including the resumed part)
+    qint64 _bytesReceived;
+    /// End of the range received on this connection (the file size for single stream transfers)
+    qint64 _rangeEnd;
+    /// Bytes of the current file received by the extra connections
+    qint64 _streamBytes;
+    /// Extra connections of the current file still running
+    unsigned _pendingStreams;
+    /// Boolean for the range header reception (extra connection)
+    bool _bRange;
+    /// Session receiving the file this extra connection writes a range of
+    QPointer<ReceiveSession> _streamOwner;
+    /// Extractor of the current folder, null for regular files
+    FolderExtractor *_extractor;
+    /// Trace of the file being received
+    TraceSpan _fileSpan;
+    /// Trace of the folder being extracted
+    TraceSpan _extractSpan;
+    /// Name of the file being received
+    QString _filename;
+    /// Current history Element
+    HistoryElement _currentHistoryElement;
+    /// Progress modification counter
+    unsigned _progressCounter;
+    /// Data read from the file
+    QByteArray _socketContent;
+    /// File to write
+    QFile _file;
+    /// Reusable buffer between the socket and the file (fast receive mode)
+    QByteArray _receiveBuffer;
+    /// Preallocate the file and write it through _receiveBuffer
+    bool _fastReceive;
+    /// True once finished() has been emitted
+    bool _finished;
+    /// True once the service admitted the transfer or the stream of the session
+    bool _admitted;
+    /// Closes the persistent session once idle
+    QTimer _idleTimer;
+
+    /**
+     * Interrupt the current transfer and close the session
+     *
+     * @param keepPartialFile Keep the partial file and its journal to resume it later
+     */
+    void interruptTransfer(bool keepPartialFile);
+    /**
+     * Write the resume journal of the current file
+     */
+    void saveJournal();
+    /**
+     * Read the header and the content of a range (extra connection of a multi-stream file)
+     *
+     * @return True if the range is over, false if more bytes are expected
+     */
+    bool readStreamRange();
+    /**
+     * Choose the number of connections for the current file and answer the sender
+     *
+     * @param requested Number of connections requested by the sender
+     */
+    void negotiateStreams(unsigned requested);
+    /**
+     * Notify the progress of the current file if it moved enough
+     */
+    void updateProgress();
+    /**
+     * Tells if a whole QString is available on the socket
+     */
+    bool isStringAvailable() const;
+    /**
+     * Tells if the current file is a zipped folder
+     */
+    bool isFolder() const;
+    /**
+     * Tells if the destination of the current file is opened
+     */
+    bool isOutputOpen() const;
+    /**
+     * Open the destination of the current file
+     * Folders are extracted as they arrive, files are written in the destination folder
+     *
+     * @return True if the destination is opened, false otherwise
+     */
+    bool openOutput();
+    /**
+     * Move the available socket bytes of the current file to its destination
+     * through the reusable buffer, without reading past the end of the file
+     *
+     * @return False if the bytes cannot be written, true otherwise
+     */
+    bool writeSocketContent();
+    /**
+     * Close the socket and notify the service
+     */
+    void finish();
+    /**
+     * Get the trace track of the session
+     *
+     * @return The track name
+     */
+    QString getTraceTrack() const;
+};
+
+#endif // RECEIVESESSION_H
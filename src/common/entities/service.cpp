@@ -22,13 +22,8 @@
 #include <QString>
 #include <QDataStream>
 #include <QDebug>
-#include <QApplication>
-#include <QByteArray>
 #include <QFile>
-#include <QDesktopServices>
 #include <QDir>
-#include <QUrl>
-#include <QClipboard>
 #include <QUuid>
 
 #include "service.h"
@@ -38,32 +33,22 @@
 #include "helpers/settingsmanager.h"
 #include "config/appconfig.h"
 #include "txtrecord.h"
-#include "helpers/folderzipper.h"
-#include "threads/clipboardthreadevent.h"
 #include "controller.h"
 
 const QString Service::HistoryFileName = FileHelper::getFileStorageLocation() + "/" + HISTORY_FILE;
 
-Service::Service(UdpDiscovery *discovery, Controller *controller) :
-    _socket(0),
-    _bDataSize(false),
-    _bDataType(false),
-    _bUid(false),
-    _bName(false),
-    _bType(false),
-    _bFilename(false),
-    _bFileSize(false),
-    _progressCounter(0),
+Service::Service(UdpDiscovery *discovery, Controller *controller, const QString &historyFileName) :
     _bonjourRegister(0),
     _tcpServer(this),
     _timer(this),
-    _controller(controller)
+    _history(historyFileName, this),
+    _controller(controller),
+    _reservedStreams(0)
 {
     qRegisterMetaType<HistoryElement>("HistoryElement");
     qRegisterMetaType<QList<HistoryElement> >("QList<HistoryElement>");
     qRegisterMetaType< ServiceErrorState >("ServiceErrorState");
 
-    _socket = new QTcpSocket();
     _udpDiscovery = discovery;
 
     connect(_udpDiscovery, SIGNAL(needRecord(QHostAddress *)), this, SLOT(sendRecord(QHostAddress *)));
@@ -80,11 +65,8 @@ Service::~Service()
 {
     serviceUnregister();
     _timer.stop();
-    if (_socket)
-    {
-        onDeviceDisconnected();
-        delete _socket;
-    }
+    qDeleteAll(_sessions);
+    _sessions.clear();
 }
 
 void Service::sendRecord(QHostAddress *address)
@@ -96,6 +78,11 @@ void Service::sendRecord(QHostAddress *address)
 }
 
 QList<HistoryElement> Service::getHistory()
+{
+    return _history.getElements();
+}
+
+HistoryStore &Service::getHistoryStore()
 {
     return _history;
 }
@@ -105,519 +92,336 @@ void Service::onNewConnection()
     manageNewConnection(_tcpServer);
 }
 
+Controller *Service::getController() const
+{
+    return _controller;
+}
+
 void Service::manageNewConnection(QTcpServer &server)
 {
-    if (!_socket->isOpen())
+    // Idle persistent sessions give way to new connections
+    if (server.hasPendingConnections() && _sessions.size() - _heldSessions.size() >= SettingsManager::getMaxSessions())
     {
-        delete _socket;
-        _socket = server.nextPendingConnection();
-
-        connect(_socket, SIGNAL(readyRead()),
-                this, SLOT(onDataReceived()));
-        connect(_socket, SIGNAL(disconnected()),
-                this, SLOT(onDeviceDisconnected()));
-        connect(_socket, SIGNAL(error(QAbstractSocket::SocketError)),
-                this, SLOT(socketError(QAbstractSocket::SocketError)));
+        foreach (ReceiveSession *session, _sessions)
+        {
+            if (session->isIdle())
+            {
+                session->onSessionIdle();
+                break;
+            }
+        }
     }
-}
 
-void Service::onTimerOut()
-{
-    serviceUnregister();
-    serviceRegister();
+    // Extra connections stay pending in the server until a session ends
+    // Held sessions do not count, so that the streams of a file can always reach their reserved slots
+    while (server.hasPendingConnections()
+           && _sessions.size() - _heldSessions.size() < SettingsManager::getMaxSessions()
+           && _heldSessions.size() < SettingsManager::getMaxSessions())
+    {
+        ReceiveSession *session = new ReceiveSession(server.nextPendingConnection(), this);
+
+        connect(session, SIGNAL(finished(ReceiveSession*)),
+                this, SLOT(onSessionFinished(ReceiveSession*)));
+        connect(session, SIGNAL(cannotCreateFile()),
+                this, SLOT(onSessionCannotCreateFile()));
+        connect(session, SIGNAL(historyElementProgressUpdated(const HistoryElement&, unsigned)),
+                this, SIGNAL(historyElementProgressUpdated(const HistoryElement&, unsigned)));
+        connect(session, SIGNAL(receivingFile(const QString&,int)),
+                this, SIGNAL(receivingFile(const QString&,int)));
+        connect(session, SIGNAL(receivingFolder(const QString&,int)),
+                this, SIGNAL(receivingFolder(const QString&,int)));
+        connect(session, SIGNAL(receivingText(const QString&)),
+                this, SIGNAL(receivingText(const QString&)));
+        connect(session, SIGNAL(receivingUrl(const QString&)),
+                this, SIGNAL(receivingUrl(const QString&)));
+
+        _sessions.append(session);
+        DEBUG_LOG(LOG_CONNECTION, "[Service] New receive session (IP - " + session->getSocket()->peerAddress().toString()
+                                  + ", " + QString::number(_sessions.size()) + " running)");
+    }
 }
 
-void Service::resetService()
+unsigned Service::reserveStreams(ReceiveSession *owner, unsigned requested, quint32 &token)
 {
-    _socket->close();
-    if (_file.isOpen())
-        _file.close();
-
-    _bDataSize = false;
-    _bUid = false;
-    _bName = false;
-    _bType = false;
-    _bFilename = false;
-    _bDataType = false;
-    _bFileSize = false;
-    _progressCounter = 0;
-    _socketContent.clear();
-}
+    // Extra connections need free sessions, otherwise they would wait behind the file they belong to
+    int available = SettingsManager::getMaxSessions() - (_sessions.size() - _heldSessions.size()) - _reservedStreams;
+    int accepted = qMin((int)requested, SettingsManager::getMaxStreams());
 
-void Service::socketError(QAbstractSocket::SocketError)
-{
-    LogManager::appendLine("[Service] Socket ERROR - " + _socket->errorString() + " (IP - " + _socket->peerName() + ")");
+    accepted = qMax(1, qMin(accepted, available + 1));
 
-    deleteFileReset();
-}
+    if (accepted > 1)
+    {
+        do
+            token = qHash(QUuid::createUuid().toString());
+        while (token == 0 || _streamReservations.contains(token));
 
-void Service::deleteFileReset()
-{
-    if (_bDataType && DataStruct::isFileType(DataType(_dataType))) {
-        removeCurrentFile();
-        serializeHistory();
+        _streamReservations.insert(token, qMakePair(owner, (unsigned)accepted - 1));
+        _reservedStreams += accepted - 1;
     }
 
-    resetService();
+    return accepted;
 }
 
-void Service::serviceRegister()
+ReceiveSession *Service::claimStream(quint32 token)
 {
+    if (!_streamReservations.contains(token))
+        return 0;
 
-    if (!isRegistered())
-    {
-        _tcpServer.listen(QHostAddress::Any);
-        if (!_tcpServer.isListening())
-        {
-            LogManager::appendLine("[Service] TcpServer ERROR - Could not listen");
-            emit serviceError(CANNOT_LAUNCH_SERVICE, true);
-            return;
-        }
-
-        _udpDiscovery->announce(_tcpServer.serverPort());
-        _bonjourRegister = new BonjourServiceRegister(this);
-        connect(_bonjourRegister, SIGNAL(error(DNSServiceErrorType)), this, SLOT(error(DNSServiceErrorType)));
+    QPair<ReceiveSession *, unsigned> &reservation = _streamReservations[token];
+    ReceiveSession *owner = reservation.first;
 
-        BonjourRecord br(SettingsManager::getServiceDeviceName(), QLatin1String(SERVICE_TYPE), QLatin1String(BONJOUR_DOMAIN));
+    --_reservedStreams;
+    if (--reservation.second == 0)
+        _streamReservations.remove(token);
 
-        TxtRecord record;
-        record.append(QLatin1String(KEY_TYPE), QLatin1String(SettingsManager::getType().toStdString().c_str()));
-        record.append(QLatin1String(KEY_UID), SettingsManager::getDeviceUID());
-        record.append(QLatin1String(KEY_VERSION), QLatin1String(PROTOCOL_VERSION));
-        record.getData();
-        _bonjourRegister->registerService(br, record.getData(), _tcpServer.serverPort());
-        _timer.start(RESTART_REGISTER_TIMER);
-        LogManager::appendLine("[Service] Service registered (UID : " + SettingsManager::getDeviceUID() + ", PORT : " + QString::number(_tcpServer.serverPort()) + ")");
-    }
+    return owner;
 }
 
-bool Service::isRegistered()
+bool Service::admitTransfer(ReceiveSession *session)
 {
-    return (_bonjourRegister != NULL);
-}
+    int admitted = 0;
 
-void Service::serviceUnregister()
-{
-    if (isRegistered())
+    foreach (ReceiveSession *running, _sessions)
     {
-        _udpDiscovery->leave();
-        if (_tcpServer.isListening())
-            _tcpServer.close();
-        delete _bonjourRegister;
-        _bonjourRegister = 0;
-        _timer.stop();
-        LogManager::appendLine("[Service] Service unregistered");
+        if (running->isAdmitted())
+            ++admitted;
+    }
+
+    if (admitted + _reservedStreams < SettingsManager::getMaxSessions())
+    {
+        _heldSessions.removeOne(session);
+        return true;
+    }
+
+    if (!_heldSessions.contains(session))
+    {
+        DEBUG_LOG(LOG_CONNECTION, "[Service] Session held, its slot is reserved for streams (IP - "
+                                  + session->getSocket()->peerAddress().toString() + ")");
+        _heldSessions.append(session);
     }
+
+    return false;
 }
 
-void Service::onDeviceDisconnected()
+void Service::resumeHeldSessions()
 {
-    _socket->abort();
-    _socket->close();
+    foreach (ReceiveSession *session, _heldSessions)
+        QMetaObject::invokeMethod(session, "onDataReceived", Qt::QueuedConnection);
 }
 
-void Service::onDataReceived()
-{    
-    QDataStream stream(_socket);
-    do
-    {
-        if (!_bUid)
-        {
-            if (_socket->bytesAvailable() < sizeof(unsigned))
-                return;
-            stream >> _dataUid;
-            _bUid = true;
-        }
-        if (!_bName)
-        {
-            if (_socket->bytesAvailable() < sizeof(unsigned))
-                return;
-            stream >> _dataName;
-            _bName = true;
-        }
-        if (!_bType)
-        {
-            if (_socket->bytesAvailable() < sizeof(unsigned))
-                return;
-            stream >> _serverType;
-            _bType = true;
-        }
-        if (!_bDataType)
-        {
-            if (_socket->bytesAvailable() < sizeof(unsigned))
-                return;
-            stream >> _dataType;
-            _bDataType = true;
-        }
-        if (!_bDataSize)
-        {
-            if (_socket->bytesAvailable() < sizeof(unsigned))
-                return;
-            stream >> _dataSize;
-            _bDataSize = true;
-        }
+void Service::releaseStreams(ReceiveSession *owner)
+{
+    QMutableHashIterator<quint32, QPair<ReceiveSession *, unsigned> > it(_streamReservations);
 
-        if (DataStruct::isFileType(DataType(_dataType)))
-        {
-            if (!readFile())
-                return;
-        }
-        else
+    while (it.hasNext())
+    {
+        it.next();
+        if (it.value().first == owner)
         {
-            if (!readText())
-                return;
+            _reservedStreams -= it.value().second;
+            it.remove();
         }
+    }
 
-    } while(_socket->bytesAvailable() > 2);
-
-    resetService();
+    resumeHeldSessions();
 }
 
-void Service::sendACK()
+void Service::onSessionFinished(ReceiveSession *session)
 {
-    if (_socket->isOpen())
-    {
-        QByteArray data;
-        QDataStream stream(&data, QIODevice::WriteOnly);
-
-        LogManager::appendLine("[Service] Data received, sending ACK");
+    releaseStreams(session);
+    _sessions.removeOne(session);
+    _heldSessions.removeOne(session);
+    session->deleteLater();
 
-        // Data type
-        stream << (unsigned)TYPE_ACK;
-
-        _socket->write(data);
-    }
+    manageNewConnection(_tcpServer);
 }
 
-void Service::sendMessage(MessageType type, const QString &message)
+void Service::onSessionCannotCreateFile()
 {
-    if (_socket->isOpen())
-    {
-        QByteArray data;
-        QDataStream stream(&data, QIODevice::WriteOnly);
-
-        LogManager::appendLine("[Service] Send message : " + message);
-
-        // Data type
-        stream << (unsigned)TYPE_MESSAGE;
-        // Message type
-        stream << (unsigned)type;
-        // Message
-        stream << message;
-
-        _socket->write(data);
-    }
+    emit serviceError(CANNOT_CREATE_FILE, false);
 }
 
-void Service::sendProgress(unsigned percentage)
+void Service::onTimerOut()
 {
-    QByteArray data;
-    QDataStream stream(&data, QIODevice::WriteOnly);
-
-    stream << (unsigned)TYPE_DOWNLOAD_PROGRESS;
-    _socket->write(data);
-
-    data.clear();
-    stream.skipRawData(4);
-
-    stream << (unsigned)percentage;
-    _socket->write(data);
+    serviceUnregister();
+    serviceRegister();
 }
 
-bool Service::readFile()
+void Service::cancelIncomingTransfert(const HistoryElement &element)
 {
-    QDataStream stream(_socket);
-    int notifyFactor = NOTIFY_FACTOR;
-    QDir receptionDir;
-    static QString filename;
-
-    if (_socket->isOpen())
+    // The other sessions keep receiving
+    foreach (ReceiveSession *session, _sessions)
     {
-        if (!_bFileSize)
-        {
-            if (_socket->bytesAvailable() < sizeof(unsigned))
-                return false;
-            stream >> _fileSize;
-            _bFileSize = true;
-        }
-
-        if (!_bFilename)
+        if (session->isReceiving(element))
         {
-            if (_socket->bytesAvailable() < sizeof(unsigned))
-                return false;
-            stream >> filename;
-            _bFilename = true;
-
-            if (filename.contains(ZIP_EXTENSION)) {
-                QString noExtension = filename;
-                noExtension.remove(ZIP_EXTENSION);
-                _currentHistoryElement = HistoryElement(QDateTime::currentDateTime(), noExtension, _dataName, _fileSize, HISTORY_FOLDER_TYPE);
-                emit receivingFolder(noExtension, _fileSize);
-            } else {
-                _currentHistoryElement = HistoryElement(QDateTime::currentDateTime(), filename, _dataName, _fileSize, HISTORY_FILE_TYPE);
-                emit receivingFile(filename, _fileSize);
-            }
-            addCurrentElementToHistory();
+            session->deleteFileReset();
+            break;
         }
+    }
+}
 
-        if(_file.isOpen() && _fileSize != 0
-                && (_socket->bytesAvailable() + _file.size()) < _fileSize
-                && (_socket->bytesAvailable() + _file.size()) < notifyFactor)
-            return false;
-
-        _socketContent = _socket->read(_socket->bytesAvailable());
+void Service::serviceRegister()
+{
 
-        if (!_file.isOpen())
-        {
-            receptionDir.mkpath(SettingsManager::getDestinationFolder());
-            _file.setFileName(SettingsManager::getDestinationFolder() + "/" + filename);
-            if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
-            {
-                LogManager::appendLine("[Service] File ERROR - Can't create the file");
-                emit serviceError(CANNOT_CREATE_FILE, false);
-                resetService();
-                return true;
-            }
-        }
-        _file.write(_socketContent);
-        if (_file.size() > notifyFactor * _progressCounter)
+    if (!isRegistered())
+    {
+        _tcpServer.listen(QHostAddress::Any);
+        if (!_tcpServer.isListening())
         {
-            unsigned progress = (_file.size() * 100) / _fileSize;
-            sendProgress(progress);
-            emit historyElementProgressUpdated(progress);
-            ++_progressCounter;
+            ERROR_LOG(LOG_GENERAL, "[Service] TcpServer ERROR - Could not listen");
+            emit serviceError(CANNOT_LAUNCH_SERVICE, true);
+            return;
         }
 
-        if (_file.size() < _fileSize)
-            return false;
-
-        _file.close();
-
-        decompressFolder(filename);
-
-        emit historyElementProgressUpdated(100);
-        serializeHistory();
-        LogManager::appendLine("[Service] [FILE] " + filename + " written");
-
-        if (_dataType == TYPE_FILE_OPEN && SettingsManager::isAutoOpenFilesEnabled())
-        {
-            QFileInfo fileInfo(SettingsManager::getDestinationFolder() + "/" + filename);
-            FileHelper::openURL("file:///" + fileInfo.absoluteFilePath());
-        }
+        _udpDiscovery->announce(_tcpServer.serverPort());
+        _bonjourRegister = new BonjourServiceRegister(this);
+        connect(_bonjourRegister, SIGNAL(error(DNSServiceErrorType)), this, SLOT(error(DNSServiceErrorType)));
 
-        _bFileSize = false;
-        _bFilename = false;
-        _progressCounter = 0;
-        _socketContent.clear();
+        BonjourRecord br(SettingsManager::getServiceDeviceName(), QLatin1String(SERVICE_TYPE), QLatin1String(BONJOUR_DOMAIN));
 
-        sendACK();
+        TxtRecord record;
+        record.append(QLatin1String(KEY_TYPE), QLatin1String(SettingsManager::getType().toStdString().c_str()));
+        record.append(QLatin1String(KEY_UID), SettingsManager::getDeviceUID());
+        record.append(QLatin1String(KEY_VERSION), QLatin1String(PROTOCOL_VERSION));
+        record.append(QLatin1String(KEY_FEATURES), QString::number(PROTOCOL_FEATURES));
+        record.getData();
+        _bonjourRegister->registerService(br, record.getData(), _tcpServer.serverPort());
+        _timer.start(RESTART_REGISTER_TIMER);
+        INFO_LOG(LOG_GENERAL, "[Service] Service registered (UID : " + SettingsManager::getDeviceUID() + ", PORT : " + QString::number(_tcpServer.serverPort()) + ")");
     }
-
-    // Here _dataSize is the number of files (if there is remaining files, return false)
-    return (--_dataSize <= 0);
 }
 
-void Service::decompressFolder(QString &filename)
+quint16 Service::listenOnLoopback()
 {
-    if (filename.endsWith(ZIP_EXTENSION))
+    if (!_tcpServer.isListening() && !_tcpServer.listen(QHostAddress::LocalHost))
     {
-        QString filePath = SettingsManager::getDestinationFolder() + "/" + filename;
-        QString folderPath = filePath;
-
-        folderPath.remove(ZIP_EXTENSION);
-        LogManager::appendLine("[Server] Unzipping directory (" + folderPath + ")");
-        FolderZipper::decompressFolder(filePath, folderPath);
-        FileHelper::deleteFileFromDisk(filename);
-
-        filename.remove(ZIP_EXTENSION);
+        ERROR_LOG(LOG_GENERAL, "[Service] TcpServer ERROR - Could not listen on the loopback");
+        return 0;
     }
-}
 
-void Service::addCurrentElementToHistory()
-{
-    if (_history.size() >= MAX_HISTORY_SIZE)
-        _history.removeLast();
-
-    _history.push_front(_currentHistoryElement);
-    emit historyChanged(_history);
-    serializeHistory();
+    return _tcpServer.serverPort();
 }
 
-void Service::onDeleteFromHistory(int row)
+bool Service::isRegistered()
 {
-    if (_history.size() >= row)
-        _history.removeAt(row);
-
-    serializeHistory();
+    return (_bonjourRegister != NULL);
 }
 
-void Service::removeCurrentFile()
+void Service::serviceUnregister()
 {
-    removeCurrentFileFromHistory();
-    if (_file.isOpen())
+    if (isRegistered())
     {
-        _file.close();
-        if (_file.size() < _fileSize)
-            FileHelper::deleteFileFromDisk(_file);
+        _udpDiscovery->leave();
+        if (_tcpServer.isListening())
+            _tcpServer.close();
+        delete _bonjourRegister;
+        _bonjourRegister = 0;
+        _timer.stop();
+        INFO_LOG(LOG_GENERAL, "[Service] Service unregistered");
     }
 }
 
-void Service::removeCurrentFileFromHistory()
+void Service::addElementToHistory(const HistoryElement &element)
 {
-    if (!_history.isEmpty()) {
-        _history.removeFirst();
-        emit historyChanged(_history);
-    }
+    _history.append(element);
+    emit historyElementAdded(element);
 }
 
-void Service::onClearHistory()
+void Service::onDeleteFromHistory(int row)
 {
-    _history.clear();
-    serializeHistory();
+    _history.removeAt(row);
 }
 
-void Service::serializeHistory()
+void Service::removeElementFromHistory(const HistoryElement &element)
 {
-    QFile file(HistoryFileName);
+    int row = _history.removeOne(element);
 
-    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate))
-    {
-        QDataStream out(&file);
-        out << _history;
-        file.close();
-    }
+    if (row != -1)
+        emit historyElementRemoved(row);
+}
+
+void Service::onClearHistory()
+{
+    _history.clear();
 }
 
 void Service::deserializeHistory()
 {
-    QFile file(HistoryFileName);
     bool emptyHistory = true;
 
     // Check the history version
     if (SettingsManager::getHistoryVersion() != APP_HISTORY_VERSION)
     {
         // Delete history file
-        if (file.exists())
-        {
-            FileHelper::deleteFileFromDisk(file);
-        }
+        _history.remove();
         // Set the new version of the history protocol
         SettingsManager::setHistoryVersion(APP_HISTORY_VERSION);
     }
-    else
-    {
-        if (file.exists() && file.open(QIODevice::ReadOnly))
-        {
-            QDataStream in(&file);
-            in >> _history;
-            file.close();
 
-            emptyHistory = false;
-            //checkForHistoryExistingFiles();
-        }
+    if (_history.load())
+    {
+        emptyHistory = false;
+        //checkForHistoryExistingFiles();
     }
 
     if (emptyHistory) {
         createExampleHistory();
-        serializeHistory();
     }
 }
 
 void Service::createExampleHistory()
 {
-    _history.push_front(HistoryElement(QDateTime::currentDateTime(),
+    _history.append(HistoryElement(QDateTime::currentDateTime(),
                                        "filesdnd.mp3", "Kinoko",
                                        3500, HISTORY_FILE_TYPE));
-    _history.push_front(HistoryElement(QDateTime::currentDateTime(),
+    _history.append(HistoryElement(QDateTime::currentDateTime(),
                                        "filesdnd.xlsx", "Yusiko",
                                        92, HISTORY_FILE_TYPE));
-    _history.push_front(HistoryElement(QDateTime::currentDateTime(),
+    _history.append(HistoryElement(QDateTime::currentDateTime(),
                                        "filesdnd.doc", "Filesdnd",
                                        70, HISTORY_FILE_TYPE));
-    _history.push_front(HistoryElement(QDateTime::currentDateTime(),
+    _history.append(HistoryElement(QDateTime::currentDateTime(),
                                        "filesdnd.zip", "Windows",
                                        1024, HISTORY_FILE_TYPE));
-    _history.push_front(HistoryElement(QDateTime::currentDateTime(),
+    _history.append(HistoryElement(QDateTime::currentDateTime(),
                                        "filesdnd.avi", "John",
                                        35000, HISTORY_FILE_TYPE));
-    _history.push_front(HistoryElement(QDateTime::currentDateTime(),
+    _history.append(HistoryElement(QDateTime::currentDateTime(),
                                        "filesdnd.pdf", "Drusy",
                                        310, HISTORY_FILE_TYPE));
-    _history.push_front(HistoryElement(QDateTime::currentDateTime(),
+    _history.append(HistoryElement(QDateTime::currentDateTime(),
                                        "filesdnd", "Nitrog42",
                                        10000, HISTORY_FOLDER_TYPE));
-    _history.push_front(HistoryElement(QDateTime::currentDateTime(),
+    _history.append(HistoryElement(QDateTime::currentDateTime(),
                                        "Files Drag & Drop rocks!", "Nexus 7",
                                        24, HISTORY_TEXT_TYPE));
-    _history.push_front(HistoryElement(QDateTime::currentDateTime(),
+    _history.append(HistoryElement(QDateTime::currentDateTime(),
                                        "http://www.filesdnd.com", "MacBook",
                                        23, HISTORY_URL_TYPE));
-    _history.push_front(HistoryElement(QDateTime::currentDateTime(),
+    _history.append(HistoryElement(QDateTime::currentDateTime(),
                                        "filesdnd-v2.png", "Android",
                                        3500, HISTORY_FILE_TYPE));
 
-    emit historyChanged(_history);
+    emit historyChanged(_history.getElements());
 }
 
 void Service::checkForHistoryExistingFiles()
 {
     QList<HistoryElement> toRemove;
 
-    foreach (HistoryElement elt, _history)
+    foreach (HistoryElement elt, _history.getElements())
     {
         if (elt.isFile() && !FileHelper::exists(elt.getText()))
             toRemove.append(elt);
     }
 
-    if (!toRemove.isEmpty())
+    foreach (HistoryElement elt, toRemove)
     {
-        foreach (HistoryElement elt, toRemove)
-        {
-            _history.removeOne(elt);
-        }
-
-        serializeHistory();
+        _history.removeOne(elt);
     }
 }
 
-bool Service::readText()
-{
-    QDataStream stream(_socket);
-    QString text;
-
-    if(_socket->bytesAvailable() < _dataSize)
-        return false;
-
-    stream >> text;
-
-    // Notify the controller for a clipboard save
-    QApplication::postEvent(_controller, new ClipboardThreadEvent(text));
-
-    if (_dataType == TYPE_URL_OPEN)
-    {
-        emit receivingUrl(text);
-        LogManager::appendLine("[Service] [URL] '" + text + "' opened");
-        if (SettingsManager::isAutoOpenFilesEnabled())
-            FileHelper::openURL(text);
-
-        _currentHistoryElement = HistoryElement(QDateTime::currentDateTime(), text, _dataName, _dataSize, HISTORY_URL_TYPE);
-    }
-    else
-    {
-        emit receivingText(text);
-        LogManager::appendLine("[Service] [TEXT] '" + text + "' saved into clipboard");
-
-        _currentHistoryElement = HistoryElement(QDateTime::currentDateTime(), text, _dataName, _dataSize, HISTORY_TEXT_TYPE);
-    }
-
-    addCurrentElementToHistory();
-
-    sendACK();
-
-    return true;
-}
-
 void Service::error(DNSServiceErrorType error)
 {
-    LogManager::appendLine("[Service] MDNS ERROR (" + QString::number(error) + ") - Is the Bonjour service launched ?");
+    ERROR_LOG(LOG_DISCOVERY, "[Service] MDNS ERROR (" + QString::number(error) + ") - Is the Bonjour service launched ?");
 }
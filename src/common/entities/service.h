@@ -24,12 +24,15 @@
 #include <QObject>
 #include <QTcpServer>
 #include <QTimer>
-#include <QFile>
 #include <QTcpSocket>
+#include <QHash>
+#include <QPair>
 
 #include "zeroconf/bonjourserviceregister.h"
 #include "zeroconf/bonjourrecord.h"
 #include "historyelement.h"
+#include "historystore.h"
+#include "receivesession.h"
 #include "config/appconfig.h"
 #include "udp/udpdiscovery.h"
 
@@ -57,35 +60,17 @@ class Service : public QObject
 public:
     /**
       * Constructor
+      *
+      * @param discovery Udp discovery module
+      * @param controller Controller receiving the clipboard events
+      * @param historyFileName File of the received file history
       */
-    Service(UdpDiscovery *discovery, Controller *controller);
+    Service(UdpDiscovery *discovery, Controller *controller, const QString &historyFileName = HistoryFileName);
     /**
       * Destructor
       */
     ~Service();
 
-    /**
-      * Read a file sent by the server
-      *
-      * @return True if the file is fully read, false else
-      */
-    bool readFile();
-    /**
-      * Read a text sent by the server
-      *
-      * @return True if the text is fully read, false else
-      */
-    bool readText();
-    /**
-      * Send ACK to the server
-      */
-    void sendACK();
-    /**
-     * Send the progress of the download
-     *
-     * @param percentage Progress in percent
-     */
-    void sendProgress(unsigned percentage);
     /**
       * Tells if the service is registered or not
       *
@@ -93,52 +78,70 @@ public:
       **/
     bool isRegistered();
     /**
-     * Add a element to the history
-     */
-    void addCurrentElementToHistory();
-    /**
-     * On error, remove the incorrect file from the history
+     * Add an element to the history
+     *
+     * @param element Element to add
      */
-    void removeCurrentFileFromHistory();
+    void addElementToHistory(const HistoryElement &element);
     /**
-     * Serialize history as a binary file
+     * On error, remove an incorrect element from the history
+     *
+     * @param element Element to remove
      */
-    void serializeHistory();
+    void removeElementFromHistory(const HistoryElement &element);
     /**
-     * Deserialize history from a binary file
+     * Load the history from its file
      */
     void deserializeHistory();
-    /**
-     * Send message to the current opened socket
-     *
-     * @param type Message type, overlay or popup
-     * @param message Message to send
-     */
-    void sendMessage(MessageType type, const QString &message);
     /**
      * Getter : _history
      */
     QList<HistoryElement> getHistory();
     /**
-      * Set the default values for the service
-      */
-    void resetService();
-    /**
-     * On socket error, remove the current file if it is not properly written
+     * Getter : _history
      */
-    void removeCurrentFile();
+    HistoryStore &getHistoryStore();
     /**
-     * Decompress folders and all subfolders
-     *
-     * @param filename Zipped file
+     * Getter : _controller
      */
-    void decompressFolder(QString &filename);
+    Controller *getController() const;
     /**
      * Manage a new connection on a tcp server
+     * A receive session is created for each connection, up to SettingsManager::getMaxSessions()
      *
      * @param server Tcp server that need to handle connection
      */
     void manageNewConnection(QTcpServer &server);
+    /**
+     * Reserve the sessions of the extra connections of a multi-stream file
+     *
+     * @param owner Session receiving the file
+     * @param requested Number of connections requested by the sender
+     * @param token Set to the token the extra connections will present
+     * @return Number of connections accepted, 1 if the file is received on a single connection
+     */
+    unsigned reserveStreams(ReceiveSession *owner, unsigned requested, quint32 &token);
+    /**
+     * Attach an extra connection to the session it has been reserved for
+     *
+     * @param token Token presented by the connection
+     * @return Session receiving the file, null if the token is unknown
+     */
+    ReceiveSession *claimStream(quint32 token);
+    /**
+     * Release the reserved sessions that have not been claimed
+     *
+     * @param owner Session receiving the file
+     */
+    void releaseStreams(ReceiveSession *owner);
+    /**
+     * Admit the transfer of a session if a slot is free once the reserved streams are counted
+     * A session that is not admitted is held, it is resumed once a slot is freed
+     *
+     * @param session Session starting a transfer
+     * @return True if the session may receive, false if it is held
+     */
+    bool admitTransfer(ReceiveSession *session);
 
 public slots:
     /**
@@ -150,25 +153,33 @@ public slots:
       */
     void serviceUnregister();
     /**
-      * SLOT : On data received (File or text)
+      * SLOT : Listen on the loopback only, without registering the service
+      *
+      * @return The port listened on, 0 if the server could not listen
       */
-    void onDataReceived();
+    quint16 listenOnLoopback();
     /**
       * SLOT : On new connexion (callback from accept state of the TcpServer)
       */
     void onNewConnection();
     /**
-      * SLOT : On device disconnected
+      * SLOT : On receive session ended
+      *
+      * @param session Ended session
       */
-    void onDeviceDisconnected();
+    void onSessionFinished(ReceiveSession *session);
+    /**
+      * SLOT : Resume the held sessions, a slot may have been freed
+      */
+    void resumeHeldSessions();
+    /**
+      * SLOT : A receive session could not create its file
+      */
+    void onSessionCannotCreateFile();
     /**
      * Timer out, have to register again
      */
     void onTimerOut();
-    /**
-      * On socket error
-      */
-    void socketError(QAbstractSocket::SocketError);
     /**
       * On history entry deleted
       */
@@ -188,21 +199,36 @@ public slots:
      */
     void sendRecord(QHostAddress *address);
     /**
-     * Interrupt the current download, delete the file, change history
+     * Interrupt a download, delete its file, change history
+     *
+     * @param element History element of the download
      */
-    void deleteFileReset();
+    void cancelIncomingTransfert(const HistoryElement &element);
 
 signals:
     /**
      * Notify an history change
      */
     void historyChanged(const QList<HistoryElement> &history);
+    /**
+     * Notify an element added on top of the history
+     *
+     * @param element New history element
+     */
+    void historyElementAdded(const HistoryElement &element);
+    /**
+     * Notify an element removed from the history
+     *
+     * @param row Row of the removed element, 0 being the most recent
+     */
+    void historyElementRemoved(int row);
     /**
      * Notify the view of the download progress
      *
+     * @param element History element being downloaded
      * @param progress Download progress percentage
      */
-    void historyElementProgressUpdated(unsigned progress);
+    void historyElementProgressUpdated(const HistoryElement &element, unsigned progress);
     /**
       * Notify the view for an error in the service
       * This error could be critical, in this case, it means that the service should stop.
@@ -243,46 +269,18 @@ private:
     BonjourServiceRegister *_bonjourRegister;
     /// Server for connection to the service
     QTcpServer _tcpServer;
-    /// Socket for connectins
-    QTcpSocket *_socket;
-    /// Boolean for the data size reception
-    bool _bDataSize;
-    /// Boolean for the data tye reception
-    bool _bDataType;
-    /// Size of the data to read on the socket
-    unsigned _dataSize;
-    /// Size of the file
-    qint64 _fileSize;
-    /// Uid of the server
-    QString _dataUid;
-    /// Name of the server
-    QString _dataName;
-    /// Type of the server
-    QString _serverType;
-    /// Boolean for the uid
-    bool _bUid;
-    /// Boolean for the name
-    bool _bName;
-    /// Boolean for the type
-    bool _bType;
-    /// Boolean for the file size
-    bool _bFileSize;
-    /// Type of the data
-    unsigned _dataType;
+    /// Running receive sessions, one per connection
+    QList<ReceiveSession *> _sessions;
+    /// Sessions waiting for a slot, they do not count against MaxSessions
+    QList<ReceiveSession *> _heldSessions;
+    /// Multi-stream files by token : receiving session and extra connections not arrived yet
+    QHash<quint32, QPair<ReceiveSession *, unsigned> > _streamReservations;
+    /// Sessions kept for the extra connections not arrived yet
+    int _reservedStreams;
     /// Timer for register again each 10 mins
     QTimer _timer;
     /// Received file history
-    QList<HistoryElement> _history;
-    /// Current history Element
-    HistoryElement _currentHistoryElement;
-    /// Boolean for file name reception
-    bool _bFilename;
-    /// Progress modification counter
-    unsigned _progressCounter;
-    /// Data read from the file
-    QByteArray _socketContent;
-    /// File to write
-    QFile _file;
+    HistoryStore _history;
     /// Udp discovery module
     UdpDiscovery *_udpDiscovery;
     /// Link to the controller (used for events sending)
@@ -0,0 +1,74 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#include "chunksizer.h"
+#include "settingsmanager.h"
+#include "appconfig.h"
+
+// Shorter windows are dominated by the timer resolution and the event loop
+#define MIN_MEASURE_WINDOW 200000 // 0.2 ms in ns
+
+ChunkSizer::ChunkSizer(qint64 chunkSize)
+{
+    reset(chunkSize);
+}
+
+void ChunkSizer::reset(qint64 chunkSize)
+{
+    _chunkSize = qBound((qint64)SettingsManager::getMinChunkSize(), chunkSize, (qint64)SettingsManager::getMaxChunkSize());
+    _throughput = 0;
+    _queuedBytes = 0;
+    _timer.invalidate();
+}
+
+void ChunkSizer::measure(qint64 queuedBytes)
+{
+    if (!_timer.isValid())
+        return;
+
+    qint64 elapsed = _timer.nsecsElapsed();
+    qint64 drained = _queuedBytes - queuedBytes;
+
+    if (elapsed < MIN_MEASURE_WINDOW || drained <= 0)
+        return;
+
+    qint64 rate = (drained * 1000000000LL) / elapsed;
+
+    _throughput = (_throughput == 0) ? rate : (3 * _throughput + rate) / 4;
+    _chunkSize = qBound((qint64)SettingsManager::getMinChunkSize(),
+                        _throughput * CHUNK_TARGET_INTERVAL / 1000,
+                        (qint64)SettingsManager::getMaxChunkSize());
+}
+
+void ChunkSizer::setQueued(qint64 queuedBytes)
+{
+    _queuedBytes = queuedBytes;
+    _timer.restart();
+}
+
+qint64 ChunkSizer::getChunkSize() const
+{
+    return _chunkSize;
+}
+
+qint64 ChunkSizer::getThroughput() const
+{
+    return _throughput;
+}
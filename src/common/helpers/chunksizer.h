@@ -0,0 +1,82 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#ifndef CHUNKSIZER_H
+#define CHUNKSIZER_H
+
+#include <QElapsedTimer>
+
+/**
+ * @class ChunkSizer
+ *
+ * Size of the chunks read from the disk for a socket, computed from its drain rate.
+ * A chunk covers about CHUNK_TARGET_INTERVAL ms of the observed throughput, within
+ * the MinChunkSize and MaxChunkSize settings : slow links get small chunks (and
+ * frequent progress), fast links get big ones.
+ */
+class ChunkSizer
+{
+public:
+    /**
+     * Constructor
+     *
+     * @param chunkSize Initial chunk size
+     */
+    explicit ChunkSizer(qint64 chunkSize);
+
+    /**
+     * Restart the measures
+     *
+     * @param chunkSize Initial chunk size
+     */
+    void reset(qint64 chunkSize);
+    /**
+     * Update the chunk size when the socket asks for more data
+     *
+     * @param queuedBytes Bytes still waiting in the socket
+     */
+    void measure(qint64 queuedBytes);
+    /**
+     * Remember what has been queued in the socket after a refill
+     *
+     * @param queuedBytes Bytes waiting in the socket
+     */
+    void setQueued(qint64 queuedBytes);
+    /**
+     * Getter : _chunkSize
+     */
+    qint64 getChunkSize() const;
+    /**
+     * Getter : _throughput (bytes per second), 0 until measured
+     */
+    qint64 getThroughput() const;
+
+private:
+    /// Current chunk size
+    qint64 _chunkSize;
+    /// Smoothed drain rate of the socket
+    qint64 _throughput;
+    /// Bytes queued in the socket after the last refill
+    qint64 _queuedBytes;
+    /// Time since the last refill
+    QElapsedTimer _timer;
+};
+
+#endif // CHUNKSIZER_H
@@ -34,6 +34,12 @@
 #include <QDebug>
 #include <QClipboard>
 
+#if defined(Q_OS_LINUX)
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/sendfile.h>
+#endif
+
 FileHelper::FileHelper()
 {
 }
@@ -117,6 +123,53 @@ QIcon FileHelper::getFileIcon(const QString &filename)
     return icon;
 }
 
+bool FileHelper::preallocate(QFile &file, qint64 size)
+{
+#if defined(Q_OS_LINUX)
+    if (file.isOpen() && size > 0)
+        return (fallocate(file.handle(), FALLOC_FL_KEEP_SIZE, 0, size) == 0);
+#else
+    Q_UNUSED(file);
+    Q_UNUSED(size);
+#endif
+
+    return false;
+}
+
+qint64 FileHelper::sendFile(QFile &file, qint64 offset, qint64 size, qintptr socket)
+{
+#if defined(Q_OS_LINUX)
+    qint64 total = 0;
+
+    if (!file.isOpen() || socket < 0)
+        return -1;
+
+    while (total < size)
+    {
+        off_t position = offset + total;
+        ssize_t sent = ::sendfile(socket, file.handle(), &position, size - total);
+
+        if (sent > 0)
+            total += sent;
+        else if (sent < 0 && errno == EINTR)
+            continue;
+        else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        else
+            return (total > 0) ? total : -1;
+    }
+
+    return total;
+#else
+    Q_UNUSED(file);
+    Q_UNUSED(offset);
+    Q_UNUSED(size);
+    Q_UNUSED(socket);
+
+    return -1;
+#endif
+}
+
 void FileHelper::deleteFileFromDisk(const QString &filename)
 {
     QString name = SettingsManager::getDestinationFolder() + "/" + filename;
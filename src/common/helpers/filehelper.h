@@ -83,6 +83,26 @@ public:
      * @param dir Directory to delete
      */
     static void deleteFileFromDisk(QDir &dir);
+    /**
+      * Reserve the disk space of a file before writing it, without changing its size
+      * Only implemented on Linux (fallocate), does nothing elsewhere
+      *
+      * @param file Opened file
+      * @param size Size to reserve
+      * @return True if the space is reserved, false otherwise
+      */
+    static bool preallocate(QFile &file, qint64 size);
+    /**
+      * Copy a part of a file to a non-blocking socket inside the kernel, without user space buffer
+      * Only implemented on Linux (sendfile), fails elsewhere
+      *
+      * @param file Opened file, its position is not used nor changed
+      * @param offset First byte to send
+      * @param size Number of bytes to send
+      * @param socket Socket descriptor
+      * @return Number of bytes sent (less than size if the socket is full), -1 if the copy is not possible
+      */
+    static qint64 sendFile(QFile &file, qint64 offset, qint64 size, qintptr socket);
     /**
       * Define if a file exists or not
       *
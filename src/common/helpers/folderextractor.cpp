@@ -0,0 +1,222 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#include "folderextractor.h"
+#include "appconfig.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QDataStream>
+#include <QStringList>
+#include <QtEndian>
+
+#define NULL_SIZE 0xFFFFFFFF
+
+FolderExtractor::FolderExtractor(const QString &destinationFolder) :
+    _destinationFolder(destinationFolder),
+    _createdFolder(false),
+    _version(0),
+    _state(STATE_NAME_SIZE),
+    _headerSize(sizeof(quint32)),
+    _remaining(0)
+{
+}
+
+FolderExtractor::~FolderExtractor()
+{
+    if (_outFile.isOpen())
+        _outFile.close();
+}
+
+bool FolderExtractor::open()
+{
+    QDir dir;
+
+    _createdFolder = !dir.exists(_destinationFolder);
+
+    return dir.mkpath(_destinationFolder);
+}
+
+bool FolderExtractor::isComplete() const
+{
+    return (_state == STATE_NAME_SIZE && _header.isEmpty());
+}
+
+void FolderExtractor::abort()
+{
+    if (_outFile.isOpen())
+        _outFile.close();
+
+    if (_createdFolder)
+        QDir(_destinationFolder).removeRecursively();
+}
+
+bool FolderExtractor::write(const char *data, qint64 size)
+{
+    while (size > 0)
+    {
+        qint64 consumed;
+
+        if (_state == STATE_DATA)
+        {
+            consumed = qMin(size, _remaining);
+            if (_outFile.isOpen() && _outFile.write(data, consumed) != consumed)
+                return false;
+
+            _remaining -= consumed;
+            if (_remaining == 0)
+                endEntry();
+        }
+        else
+        {
+            consumed = fillHeader(data, size);
+            if (_header.size() == _headerSize && !processHeader())
+                return false;
+        }
+
+        data += consumed;
+        size -= consumed;
+    }
+
+    return true;
+}
+
+qint64 FolderExtractor::fillHeader(const char *data, qint64 size)
+{
+    qint64 needed = qMin(size, _headerSize - _header.size());
+
+    _header.append(data, needed);
+
+    return needed;
+}
+
+bool FolderExtractor::processHeader()
+{
+    quint32 value;
+
+    switch (_state)
+    {
+    case STATE_VERSION:
+        _version = qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(_header.constData()) + sizeof(quint32));
+        if (_version > ARCHIVE_VERSION)
+            return false;
+
+        _header.clear();
+        _headerSize = sizeof(quint32);
+        _state = STATE_NAME_SIZE;
+        break;
+
+    case STATE_NAME_SIZE:
+        value = qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(_header.constData()));
+        if (_version == 0)
+        {
+            // No legacy entry name can be that long
+            if (value == ARCHIVE_MAGIC)
+            {
+                _headerSize += sizeof(quint32);
+                _state = STATE_VERSION;
+                break;
+            }
+            _version = ARCHIVE_LEGACY_VERSION;
+        }
+
+        if (value != NULL_SIZE && value > 0)
+        {
+            // Keep the size so that the whole QString can be read by QDataStream
+            _headerSize += value;
+            _state = STATE_NAME;
+            break;
+        }
+        // Empty name, fall through
+
+    case STATE_NAME:
+    {
+        QDataStream stream(_header);
+
+        stream >> _entryName;
+        _header.clear();
+        _headerSize = dataSizeField();
+        _state = STATE_DATA_SIZE;
+        break;
+    }
+
+    case STATE_DATA_SIZE:
+        if (_version == ARCHIVE_LEGACY_VERSION)
+        {
+            value = qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(_header.constData()));
+            _remaining = (value == NULL_SIZE) ? 0 : value;
+        }
+        else
+        {
+            _remaining = qFromBigEndian<qint64>(reinterpret_cast<const uchar *>(_header.constData()));
+            if (_remaining < 0)
+                return false;
+        }
+        _header.clear();
+        _state = STATE_DATA;
+
+        if (!startEntry())
+            return false;
+        if (_remaining == 0)
+            endEntry();
+        break;
+
+    case STATE_DATA:
+        break;
+    }
+
+    return true;
+}
+
+bool FolderExtractor::startEntry()
+{
+    QString entryName = QDir::fromNativeSeparators(_entryName);
+    QString entryPath = _destinationFolder + "/" + entryName;
+    QDir dir;
+
+    // Never write outside of the destination folder
+    if (entryName.split('/').contains(".."))
+        return false;
+
+    if (entryName.endsWith("/"))
+        return dir.mkpath(entryPath);
+
+    if (!dir.mkpath(QFileInfo(entryPath).absolutePath()))
+        return false;
+
+    _outFile.setFileName(entryPath);
+
+    return _outFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+}
+
+qint64 FolderExtractor::dataSizeField() const
+{
+    return (_version == ARCHIVE_LEGACY_VERSION) ? sizeof(quint32) : sizeof(qint64);
+}
+
+void FolderExtractor::endEntry()
+{
+    if (_outFile.isOpen())
+        _outFile.close();
+
+    _header.clear();
+    _headerSize = sizeof(quint32);
+    _state = STATE_NAME_SIZE;
+}
@@ -0,0 +1,136 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#ifndef FOLDEREXTRACTOR_H
+#define FOLDEREXTRACTOR_H
+
+#include <QString>
+#include <QByteArray>
+#include <QFile>
+
+/**
+ * @class FolderExtractor
+ *
+ * Incremental reader of the archives produced by FolderStreamer.
+ * Archive bytes are pushed as they arrive from the network and every entry
+ * is written straight to its final path, without storing the archive.
+ * The archive version is detected from its first bytes, legacy archives
+ * (without ARCHIVE_MAGIC) are still supported.
+ */
+class FolderExtractor
+{
+public:
+    /**
+     * Constructor
+     *
+     * @param destinationFolder Folder in which the entries are extracted
+     */
+    explicit FolderExtractor(const QString &destinationFolder);
+    /**
+     * Destructor
+     */
+    ~FolderExtractor();
+
+    /**
+     * Create the destination folder
+     *
+     * @return True if the folder exists or has been created, false otherwise
+     */
+    bool open();
+    /**
+     * Decode a part of the archive
+     *
+     * @param data Archive bytes
+     * @param size Number of bytes
+     * @return False if an entry cannot be written, true otherwise
+     */
+    bool write(const char *data, qint64 size);
+    /**
+     * Tells if the archive ended on an entry boundary
+     */
+    bool isComplete() const;
+    /**
+     * Stop the extraction, remove the destination folder if it has been created by the extractor
+     */
+    void abort();
+
+private:
+    /**
+     * @enum State
+     *
+     * Part of the entry being decoded
+     */
+    enum State
+    {
+        STATE_VERSION,
+        STATE_NAME_SIZE,
+        STATE_NAME,
+        STATE_DATA_SIZE,
+        STATE_DATA
+    };
+
+    /// Destination folder
+    QString _destinationFolder;
+    /// True if the destination folder did not exist before the extraction
+    bool _createdFolder;
+    /// Archive format version, 0 until the first bytes are decoded
+    quint32 _version;
+    /// Current decoding state
+    State _state;
+    /// Pending header bytes (sizes and entry name)
+    QByteArray _header;
+    /// Number of header bytes needed for the current state
+    qint64 _headerSize;
+    /// Name of the current entry
+    QString _entryName;
+    /// Remaining data bytes of the current entry
+    qint64 _remaining;
+    /// File of the current entry (not opened for folders)
+    QFile _outFile;
+
+    /**
+     * Copy header bytes until the current header field is complete
+     *
+     * @return Number of bytes consumed
+     */
+    qint64 fillHeader(const char *data, qint64 size);
+    /**
+     * Handle a complete header field and move to the next state
+     *
+     * @return False if the entry cannot be created
+     */
+    bool processHeader();
+    /**
+     * Open the file or create the folder of the current entry
+     *
+     * @return False if the entry cannot be created
+     */
+    bool startEntry();
+    /**
+     * Size of the data size field for the archive version
+     */
+    qint64 dataSizeField() const;
+    /**
+     * Close the current entry and wait for the next one
+     */
+    void endEntry();
+};
+
+#endif // FOLDEREXTRACTOR_H
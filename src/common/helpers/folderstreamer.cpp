@@ -0,0 +1,201 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#include "folderstreamer.h"
+#include "appconfig.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QDataStream>
+
+#define NULL_SIZE 0xFFFFFFFF
+
+FolderStreamer::FolderStreamer(const QString &sourceFolder, quint32 version, QObject *parent) :
+    QIODevice(parent),
+    _sourceFolder(sourceFolder),
+    _version(version),
+    _size(0),
+    _currentEntry(-1),
+    _remaining(0)
+{
+}
+
+FolderStreamer::~FolderStreamer()
+{
+    close();
+}
+
+bool FolderStreamer::open(OpenMode mode)
+{
+    if (mode != QIODevice::ReadOnly || !QDir(_sourceFolder).exists())
+        return false;
+
+    _entries.clear();
+    _header.clear();
+    _size = 0;
+    _currentEntry = -1;
+    _remaining = 0;
+
+    if (_version != ARCHIVE_LEGACY_VERSION)
+    {
+        QDataStream stream(&_header, QIODevice::WriteOnly);
+
+        stream << (quint32)ARCHIVE_MAGIC << (quint32)ARCHIVE_VERSION;
+        _size += _header.size();
+    }
+
+    if (!listEntries(_sourceFolder))
+        return false;
+
+    return QIODevice::open(mode);
+}
+
+void FolderStreamer::close()
+{
+    if (_file.isOpen())
+        _file.close();
+
+    QIODevice::close();
+}
+
+bool FolderStreamer::isSequential() const
+{
+    return true;
+}
+
+qint64 FolderStreamer::size() const
+{
+    return _size;
+}
+
+bool FolderStreamer::listEntries(const QString &sourceFolder, const QString &prefix)
+{
+    QDir dir(sourceFolder);
+    bool legacy = (_version == ARCHIVE_LEGACY_VERSION);
+    qint64 sizeField = legacy ? sizeof(quint32) : sizeof(qint64);
+
+    // Subfolders first, then files
+    dir.setFilter(QDir::NoDotAndDotDot | QDir::Hidden | QDir::Dirs);
+    foreach (QFileInfo folder, dir.entryInfoList())
+    {
+        if (!listEntries(dir.absolutePath() + "/" + folder.fileName(), prefix + "/" + folder.fileName()))
+            return false;
+    }
+
+    dir.setFilter(QDir::NoDotAndDotDot | QDir::Hidden | QDir::Files);
+    QFileInfoList filesList = dir.entryInfoList();
+
+    if (filesList.isEmpty())
+    {
+        Entry entry;
+
+        entry.name = prefix + "/";
+        entry.size = 0;
+        _entries.append(entry);
+
+        // Legacy archives store a " " marker (size and bytes with the trailing 0)
+        _size += sizeof(quint32) + entry.name.size() * sizeof(QChar) + sizeField + (legacy ? 2 : 0);
+    }
+
+    foreach (QFileInfo file, filesList)
+    {
+        Entry entry;
+
+        entry.name = prefix + "/" + file.fileName();
+        entry.path = file.absoluteFilePath();
+        entry.size = file.size();
+        _entries.append(entry);
+
+        if (legacy && entry.size >= NULL_SIZE)
+            return false;
+
+        _size += sizeof(quint32) + entry.name.size() * sizeof(QChar) + sizeField + entry.size;
+    }
+
+    return true;
+}
+
+bool FolderStreamer::nextEntry()
+{
+    if (_file.isOpen())
+        _file.close();
+
+    if (++_currentEntry >= _entries.size())
+        return false;
+
+    const Entry &entry = _entries.at(_currentEntry);
+    QDataStream stream(&_header, QIODevice::WriteOnly);
+
+    stream << entry.name;
+    if (_version != ARCHIVE_LEGACY_VERSION)
+        stream << entry.size;
+    else if (entry.path.isEmpty())
+        stream << " ";
+    else
+        stream << (quint32)entry.size;
+
+    _remaining = entry.size;
+    if (!entry.path.isEmpty())
+    {
+        _file.setFileName(entry.path);
+        _file.open(QIODevice::ReadOnly);
+    }
+
+    return true;
+}
+
+qint64 FolderStreamer::readData(char *data, qint64 maxSize)
+{
+    qint64 total = 0;
+
+    while (total < maxSize)
+    {
+        if (_header.isEmpty() && _remaining == 0 && !nextEntry())
+            break;
+
+        if (!_header.isEmpty())
+        {
+            qint64 count = qMin(maxSize - total, (qint64)_header.size());
+
+            memcpy(data + total, _header.constData(), count);
+            _header.remove(0, count);
+            total += count;
+        }
+        else
+        {
+            qint64 count = qMin(maxSize - total, _remaining);
+            qint64 read = _file.isOpen() ? _file.read(data + total, count) : -1;
+
+            // The announced size must be honored, even if the file shrunk or vanished
+            if (read < count)
+                memset(data + total + qMax(read, (qint64)0), 0, count - qMax(read, (qint64)0));
+
+            _remaining -= count;
+            total += count;
+        }
+    }
+
+    return (total == 0 && maxSize > 0) ? -1 : total;
+}
+
+qint64 FolderStreamer::writeData(const char *, qint64)
+{
+    return -1;
+}
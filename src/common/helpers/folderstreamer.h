@@ -0,0 +1,137 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#ifndef FOLDERSTREAMER_H
+#define FOLDERSTREAMER_H
+
+#include <QIODevice>
+#include <QFile>
+#include <QList>
+#include <QByteArray>
+
+/**
+ * @class FolderStreamer
+ *
+ * Read-only device producing the archive of a folder on demand.
+ * The tree is listed when the device is opened (to know the archive size),
+ * entry headers and file contents are then generated while the device is read,
+ * so a folder can be sent without writing a temporary archive.
+ *
+ * Legacy archives (version 1) are a row of QString names and QByteArray contents.
+ * Version 2 archives start with ARCHIVE_MAGIC and the version, then each entry is
+ * a QString name and a qint64 size followed by the raw content, so no entry
+ * has to fit in memory. Folder names end with a '/'.
+ */
+class FolderStreamer : public QIODevice
+{
+    Q_OBJECT
+public:
+    /**
+     * Constructor
+     *
+     * @param sourceFolder Folder to stream
+     * @param version Archive format version (ARCHIVE_LEGACY_VERSION or ARCHIVE_VERSION)
+     */
+    explicit FolderStreamer(const QString &sourceFolder, quint32 version, QObject *parent = 0);
+    /**
+     * Destructor
+     */
+    ~FolderStreamer();
+
+    /**
+     * @overload QIODevice, only ReadOnly is supported
+     * Fails if a file does not fit in the legacy format
+     */
+    bool open(OpenMode mode);
+    /**
+     * @overload QIODevice
+     */
+    void close();
+    /**
+     * @overload QIODevice
+     */
+    bool isSequential() const;
+    /**
+     * @overload QIODevice
+     *
+     * @return Size of the whole archive
+     */
+    qint64 size() const;
+
+protected:
+    /**
+     * @overload QIODevice
+     */
+    qint64 readData(char *data, qint64 maxSize);
+    /**
+     * @overload QIODevice, not supported
+     */
+    qint64 writeData(const char *data, qint64 maxSize);
+
+private:
+    /**
+     * @struct Entry
+     *
+     * Archive entry, a file or an empty folder
+     */
+    struct Entry
+    {
+        /// Name of the entry in the archive
+        QString name;
+        /// Path of the file on the disk, empty for folders
+        QString path;
+        /// Size of the file when the folder has been listed
+        qint64 size;
+    };
+
+    /// Folder to stream
+    QString _sourceFolder;
+    /// Archive format version
+    quint32 _version;
+    /// Entries of the archive
+    QList<Entry> _entries;
+    /// Size of the whole archive
+    qint64 _size;
+    /// Index of the entry being read
+    int _currentEntry;
+    /// Header bytes of the current entry not read yet
+    QByteArray _header;
+    /// Data bytes of the current entry not read yet
+    qint64 _remaining;
+    /// File of the current entry
+    QFile _file;
+
+    /**
+     * List the entries of a folder and its subfolders, subfolders first, then files
+     *
+     * @param sourceFolder Folder to list
+     * @param prefix Prefix of the entries names
+     * @return False if a file is too big for the archive version
+     */
+    bool listEntries(const QString &sourceFolder, const QString &prefix = "");
+    /**
+     * Prepare the header and the file of the next entry
+     *
+     * @return False if there is no more entry
+     */
+    bool nextEntry();
+};
+
+#endif // FOLDERSTREAMER_H
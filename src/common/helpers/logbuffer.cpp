@@ -0,0 +1,90 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#include "logbuffer.h"
+
+/// Mask giving the slot of a position
+#define LOG_BUFFER_MASK (LOG_BUFFER_SIZE - 1)
+
+LogBuffer::LogBuffer() :
+    _pushPos(0),
+    _popPos(0)
+{
+    for (int i = 0; i < LOG_BUFFER_SIZE; ++i)
+        _slots[i].sequence.store(i);
+}
+
+bool LogBuffer::push(qint64 time, const QString &line)
+{
+    uint pos = _pushPos.load();
+    Slot *slot;
+
+    forever
+    {
+        slot = &_slots[pos & LOG_BUFFER_MASK];
+        int diff = int(uint(slot->sequence.loadAcquire()) - pos);
+
+        if (diff == 0)
+        {
+            // The slot is free : claim it
+            if (_pushPos.testAndSetRelaxed(pos, pos + 1))
+                break;
+            pos = _pushPos.load();
+        }
+        else if (diff < 0)
+        {
+            // The log thread did not read this slot yet
+            return false;
+        }
+        else
+        {
+            // Another producer claimed it
+            pos = _pushPos.load();
+        }
+    }
+
+    slot->time = time;
+    slot->line = line;
+    slot->sequence.storeRelease(pos + 1);
+
+    return true;
+}
+
+bool LogBuffer::pop(qint64 &time, QString &line)
+{
+    uint pos = _popPos.load();
+    Slot *slot = &_slots[pos & LOG_BUFFER_MASK];
+
+    if (int(uint(slot->sequence.loadAcquire()) - (pos + 1)) < 0)
+        return false;
+
+    time = slot->time;
+    line = slot->line;
+    slot->line.clear();
+    slot->sequence.storeRelease(pos + LOG_BUFFER_SIZE);
+    _popPos.storeRelease(pos + 1);
+
+    return true;
+}
+
+int LogBuffer::size() const
+{
+    return int(uint(_pushPos.load()) - uint(_popPos.load()));
+}
@@ -0,0 +1,85 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#ifndef LOGBUFFER_H
+#define LOGBUFFER_H
+
+#include <QAtomicInt>
+#include <QString>
+
+#include "appconfig.h"
+
+/**
+ * @class LogBuffer
+ *
+ * Bounded lock-free ring of log lines, filled by any thread and emptied
+ * by the log thread only. Each slot holds a sequence number telling whether
+ * it is free for the producers or readable by the consumer.
+ */
+class LogBuffer
+{
+public:
+    /// Constructor
+    LogBuffer();
+
+    /**
+     * Add a line, never blocks
+     *
+     * @param time Date of the line, in ms since epoch
+     * @param line Line to add
+     * @return False if the buffer is full, true otherwise
+     */
+    bool push(qint64 time, const QString &line);
+    /**
+     * Take the oldest line, for the log thread only
+     *
+     * @param time Date of the line, in ms since epoch
+     * @param line Taken line
+     * @return False if the buffer is empty, true otherwise
+     */
+    bool pop(qint64 &time, QString &line);
+    /**
+     * Get the number of lines waiting in the buffer
+     *
+     * @return The number of lines
+     */
+    int size() const;
+
+private:
+    /// Slot of the ring
+    struct Slot
+    {
+        /// Position of the slot for the producers, position + 1 once readable
+        QAtomicInt sequence;
+        /// Date of the line
+        qint64 time;
+        /// Logged line
+        QString line;
+    };
+
+    /// Slots of the ring
+    Slot _slots[LOG_BUFFER_SIZE];
+    /// Next position written by the producers
+    QAtomicInt _pushPos;
+    /// Next position read by the log thread
+    QAtomicInt _popPos;
+};
+
+#endif // LOGBUFFER_H
@@ -22,7 +22,9 @@
 #include "settingsmanager.h"
 #include "appconfig.h"
 #include "helpers/filehelper.h"
+#include "threads/logthread.h"
 
+#include <QCoreApplication>
 #include <QDateTime>
 #include <QTextStream>
 #include <QFileInfo>
@@ -30,7 +32,11 @@
 
 const QString LogManager::LogFileName = FileHelper::getFileStorageLocation() + "/" + LOG_FILE;
 QFile LogManager::LogFile(LogFileName);
-QMutex LogManager::Mutex;
+LogBuffer LogManager::Buffer;
+LogThread *LogManager::Thread = 0;
+QAtomicInt LogManager::PendingDroppedLines(0);
+QAtomicInt LogManager::DroppedLines(0);
+QAtomicInt LogManager::ResetRequested(0);
 
 LogManager::LogManager()
 {
@@ -48,42 +54,131 @@ void LogManager::openLogFile()
 
 void LogManager::resetLog()
 {
-    if (LogFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    // The file belongs to the log thread
+    ResetRequested.storeRelease(1);
+}
+
+void LogManager::start()
+{
+    if (!Thread)
     {
-        LogFile.close();
+        Thread = new LogThread();
+        Thread->start(QThread::LowPriority);
+        qAddPostRoutine(LogManager::stop);
+    }
+}
+
+void LogManager::stop()
+{
+    if (Thread)
+    {
+        Thread->stop();
+        Thread->wait();
+        delete Thread;
+        Thread = 0;
     }
+
+    flush();
+    LogFile.close();
 }
 
 void LogManager::appendLine(const QString &logLine)
 {
-    QString dateTimeString = QDateTime::currentDateTime().toString("[dd/MM/yyyy - hh:mm:ss] ");
     if (SettingsManager::isLogEnabled())
     {
-        if (!LogFile.isOpen())
-            LogFile.open(QIODevice::ReadWrite | QIODevice::Append | QIODevice::Text);
-        if (LogFile.isOpen() && Mutex.tryLock())
+        if (!Buffer.push(QDateTime::currentMSecsSinceEpoch(), logLine))
         {
-            QTextStream out(&LogFile);
+            PendingDroppedLines.ref();
+            DroppedLines.ref();
+        }
+    }
+}
 
-            if (LogFile.size() > 1000 * 512)
-            {
-                LogFile.reset();
-                LogFile.seek(LogFile.size() - 1000 * 8);
-                QString content = LogFile.readAll();
-                LogFile.resize(0);
+bool LogManager::isEnabled(LogLevel level, LogCategory category)
+{
+    return (SettingsManager::isLogEnabled()
+            && level >= SettingsManager::getLogLevel()
+            && (SettingsManager::getLogCategories() & category));
+}
 
-                content = content.mid(content.indexOf("\n") + 1);
-                out << content;
-            }
+void LogManager::flush()
+{
+    qint64 time;
+    QString logLine;
 
-            out << dateTimeString;
-            out << logLine << endl;
+    if (ResetRequested.fetchAndStoreAcquire(0))
+    {
+        LogFile.close();
+        for (int i = 1; i < LOG_SEGMENT_COUNT; ++i)
+            QFile::remove(getSegmentFileName(i));
+        if (LogFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            LogFile.close();
+    }
 
-            #ifdef QT_DEBUG
-                qDebug() << dateTimeString + logLine;
-            #endif
+    if (Buffer.size() == 0 && PendingDroppedLines.load() == 0)
+        return;
 
-            Mutex.unlock();
-        }
+    if (!LogFile.isOpen())
+        LogFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text);
+    if (LogFile.isOpen() && LogFile.size() >= LOG_SEGMENT_SIZE)
+    {
+        rotateLogFile();
+        LogFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text);
     }
+    if (!LogFile.isOpen())
+    {
+        // Lines are lost as before when the file can't be opened
+        while (Buffer.pop(time, logLine));
+        PendingDroppedLines.store(0);
+        return;
+    }
+
+    QTextStream out(&LogFile);
+    int droppedLines = PendingDroppedLines.fetchAndStoreRelaxed(0);
+
+    while (Buffer.pop(time, logLine))
+    {
+        QString dateTimeString = QDateTime::fromMSecsSinceEpoch(time).toString("[dd/MM/yyyy - hh:mm:ss] ");
+
+        out << dateTimeString;
+        out << logLine << "\n";
+
+        #ifdef QT_DEBUG
+            qDebug() << dateTimeString + logLine;
+        #endif
+    }
+
+    if (droppedLines > 0)
+    {
+        out << QDateTime::currentDateTime().toString("[dd/MM/yyyy - hh:mm:ss] ");
+        out << "[Log] " << droppedLines << " lines dropped, the log buffer was full" << "\n";
+    }
+    out.flush();
+}
+
+int LogManager::getPendingLines()
+{
+    return Buffer.size();
+}
+
+int LogManager::getDroppedLines()
+{
+    return DroppedLines.load();
+}
+
+void LogManager::rotateLogFile()
+{
+    LogFile.close();
+
+    QFile::remove(getSegmentFileName(LOG_SEGMENT_COUNT - 1));
+    for (int i = LOG_SEGMENT_COUNT - 2; i >= 0; --i)
+    {
+        if (QFile::exists(getSegmentFileName(i)))
+            QFile::rename(getSegmentFileName(i), getSegmentFileName(i + 1));
+    }
+}
+
+QString LogManager::getSegmentFileName(int index)
+{
+    return (index == 0) ? LogFileName : LogFileName + "." + QString::number(index);
 }
@@ -22,12 +22,67 @@
 #define LOGMANAGER_H
 
 #include <QFile>
-#include <QMutex>
+#include <QAtomicInt>
+
+#include "logbuffer.h"
+
+class LogThread;
+
+/**
+  * @enum LogLevel
+  *
+  * Importance of a logged line
+  */
+enum LogLevel
+{
+    LOG_LEVEL_TRACE,
+    LOG_LEVEL_DEBUG,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_WARNING,
+    LOG_LEVEL_ERROR
+};
+
+/**
+  * @enum LogCategory
+  *
+  * Part of the application a logged line comes from, toggled at runtime
+  */
+enum LogCategory
+{
+    LOG_GENERAL = 0x01,
+    LOG_DISCOVERY = 0x02,
+    LOG_CONNECTION = 0x04,
+    LOG_TRANSFER = 0x08,
+    LOG_HISTORY = 0x10,
+    LOG_ALL_CATEGORIES = 0x1F
+};
+
+/**
+  * Log a line of a level and a category
+  * The line expression is only evaluated when the level and the category are enabled
+  */
+#define LOG_LINE(level, category, line) \
+    do { \
+        if (LogManager::isEnabled(level, category)) \
+            LogManager::appendLine(line); \
+    } while (0)
+
+#ifdef QT_DEBUG
+    #define TRACE_LOG(category, line) LOG_LINE(LOG_LEVEL_TRACE, category, line)
+#else
+    // Trace lines are compiled out of release builds
+    #define TRACE_LOG(category, line) do { } while (0)
+#endif
+#define DEBUG_LOG(category, line) LOG_LINE(LOG_LEVEL_DEBUG, category, line)
+#define INFO_LOG(category, line) LOG_LINE(LOG_LEVEL_INFO, category, line)
+#define WARNING_LOG(category, line) LOG_LINE(LOG_LEVEL_WARNING, category, line)
+#define ERROR_LOG(category, line) LOG_LINE(LOG_LEVEL_ERROR, category, line)
 
 /**
   * @class LogManager
   *
   * Manage the log file from static class
+  * The lines are queued without blocking and written by the log thread
   */
 class LogManager
 {
@@ -40,10 +95,19 @@ public:
     /**
       * Append a line on the log file
       * Prepend the line by the timedate
+      * Prefer the leveled macros, which do not build disabled lines
       *
       * @param logLine The line to log
       */
     static void appendLine(const QString &logLine);
+    /**
+      * Check if the lines of a level and a category are written
+      *
+      * @param level Level of the line
+      * @param category Category of the line
+      * @return True if the line is written, false otherwise
+      */
+    static bool isEnabled(LogLevel level, LogCategory category);
     /**
       * Getter : LogFileName
       *
@@ -58,14 +122,60 @@ public:
      * Open the log file
      */
     static void openLogFile();
+    /**
+     * Start the log thread
+     * The lines logged before are kept in the buffer
+     */
+    static void start();
+    /**
+     * Write the remaining lines and stop the log thread
+     */
+    static void stop();
+    /**
+     * Write the buffered lines to the log file, from the log thread
+     */
+    static void flush();
+    /**
+     * Get the number of lines waiting to be written
+     *
+     * @return The number of lines
+     */
+    static int getPendingLines();
+    /**
+     * Get the number of lines dropped because the buffer was full
+     *
+     * @return The number of lines
+     */
+    static int getDroppedLines();
 
 private:
     /// Log file
     static QFile LogFile;
     /// Log file name
     static const QString LogFileName;
-    /// Mutex for log printing
-    static QMutex Mutex;
+    /// Lines waiting to be written
+    static LogBuffer Buffer;
+    /// Thread writing the lines
+    static LogThread *Thread;
+    /// Lines dropped since the last flush
+    static QAtomicInt PendingDroppedLines;
+    /// Lines dropped since the start
+    static QAtomicInt DroppedLines;
+    /// Set when the file has to be cleared by the log thread
+    static QAtomicInt ResetRequested;
+
+    /**
+     * Rename the log file to a segment when it is full
+     * The older segments are shifted and the oldest one is removed
+     */
+    static void rotateLogFile();
+    /**
+     * Get the name of a log segment
+     *
+     * @param index Index of the segment, 0 being the current log file
+     * @return The file name
+     */
+    static QString getSegmentFileName(int index);
 };
 
 #endif // LOGMANAGER_H
@@ -0,0 +1,199 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#include "metricsmanager.h"
+#include "metricsserver.h"
+#include "settingsmanager.h"
+#include "logmanager.h"
+#include "helpers/filehelper.h"
+
+#include <QCoreApplication>
+#include <QMutexLocker>
+#include <QFile>
+
+/// Name and help of a metric
+struct MetricDescription
+{
+    const char *name;
+    const char *help;
+};
+
+static const MetricDescription CounterDescriptions[METRIC_COUNTER_COUNT] =
+{
+    { "filesdnd_sent_bytes_total", "Bytes of file data sent" },
+    { "filesdnd_received_bytes_total", "Bytes of file data received" },
+    { "filesdnd_discovery_datagrams_total", "Discovery datagrams processed" }
+};
+
+static const MetricDescription HistogramDescriptions[METRIC_HISTOGRAM_COUNT] =
+{
+    { "filesdnd_transfer_throughput_bytes_per_second", "Throughput of the succeeded transfers" },
+    { "filesdnd_time_to_first_byte_seconds", "Time from the start of a transfer to its first file header" },
+    { "filesdnd_ack_round_trip_seconds", "Time from the last byte of a file to its acknowledgment" },
+    { "filesdnd_resolver_latency_seconds", "Time to resolve a Bonjour service" },
+    { "filesdnd_history_persistence_seconds", "Time to write a history record" }
+};
+
+static const double TimeBuckets[METRICS_BUCKET_COUNT] =
+{
+    0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10
+};
+
+static const double ThroughputBuckets[METRICS_BUCKET_COUNT] =
+{
+    1e5, 2.5e5, 5e5, 1e6, 2.5e6, 5e6, 1e7, 2.5e7, 5e7, 1e8, 2.5e8, 5e8, 1e9
+};
+
+/**
+  * Get the upper bounds of the buckets of a histogram
+  */
+static const double *getBuckets(MetricHistogram histogram)
+{
+    return (histogram == METRIC_TRANSFER_THROUGHPUT) ? ThroughputBuckets : TimeBuckets;
+}
+
+const QString MetricsManager::MetricsFileName = FileHelper::getFileStorageLocation() + "/" + METRICS_FILE;
+qint64 MetricsManager::Counters[METRIC_COUNTER_COUNT] = { 0 };
+qint64 MetricsManager::Buckets[METRIC_HISTOGRAM_COUNT][METRICS_BUCKET_COUNT + 1] = { { 0 } };
+double MetricsManager::Sums[METRIC_HISTOGRAM_COUNT] = { 0 };
+QMutex MetricsManager::Mutex;
+MetricsServer *MetricsManager::Server = 0;
+
+void MetricsManager::start()
+{
+    if (Server || !SettingsManager::isMetricsEnabled())
+        return;
+
+    Server = new MetricsServer(QCoreApplication::instance());
+    if (Server->listen(getSocketName()))
+        INFO_LOG(LOG_GENERAL, "[Metrics] Listening on " + getSocketName());
+    else
+        ERROR_LOG(LOG_GENERAL, "[Metrics] Can't listen on " + getSocketName());
+    qAddPostRoutine(MetricsManager::dumpOnExit);
+}
+
+void MetricsManager::increment(MetricCounter counter, qint64 value)
+{
+    QMutexLocker locker(&Mutex);
+
+    Counters[counter] += value;
+}
+
+void MetricsManager::observe(MetricHistogram histogram, double value)
+{
+    const double *buckets = getBuckets(histogram);
+    int bucket = 0;
+
+    while (bucket < METRICS_BUCKET_COUNT && value > buckets[bucket])
+        ++bucket;
+
+    QMutexLocker locker(&Mutex);
+
+    ++Buckets[histogram][bucket];
+    Sums[histogram] += value;
+}
+
+QByteArray MetricsManager::toPrometheusText()
+{
+    QString text;
+    QMutexLocker locker(&Mutex);
+
+    for (int counter = 0; counter < METRIC_COUNTER_COUNT; ++counter)
+    {
+        QString name = CounterDescriptions[counter].name;
+
+        text += "# HELP " + name + " " + CounterDescriptions[counter].help + "\n";
+        text += "# TYPE " + name + " counter\n";
+        text += name + " " + QString::number(Counters[counter]) + "\n";
+    }
+
+    for (int histogram = 0; histogram < METRIC_HISTOGRAM_COUNT; ++histogram)
+    {
+        QString name = HistogramDescriptions[histogram].name;
+        const double *buckets = getBuckets((MetricHistogram)histogram);
+        qint64 count = 0;
+
+        text += "# HELP " + name + " " + HistogramDescriptions[histogram].help + "\n";
+        text += "# TYPE " + name + " histogram\n";
+
+        // Prometheus buckets are cumulative
+        for (int bucket = 0; bucket < METRICS_BUCKET_COUNT; ++bucket)
+        {
+            count += Buckets[histogram][bucket];
+            text += name + "_bucket{le=\"" + QString::number(buckets[bucket]) + "\"} " + QString::number(count) + "\n";
+        }
+        count += Buckets[histogram][METRICS_BUCKET_COUNT];
+        text += name + "_bucket{le=\"+Inf\"} " + QString::number(count) + "\n";
+        text += name + "_sum " + QString::number(Sums[histogram], 'g', 12) + "\n";
+        text += name + "_count " + QString::number(count) + "\n";
+    }
+
+    locker.unlock();
+
+    // The log queue is read from the log buffer itself
+    text += "# HELP filesdnd_log_queue_lines Log lines waiting for the log thread\n";
+    text += "# TYPE filesdnd_log_queue_lines gauge\n";
+    text += "filesdnd_log_queue_lines " + QString::number(LogManager::getPendingLines()) + "\n";
+    text += "# HELP filesdnd_log_dropped_lines_total Log lines dropped because the log queue was full\n";
+    text += "# TYPE filesdnd_log_dropped_lines_total counter\n";
+    text += "filesdnd_log_dropped_lines_total " + QString::number(LogManager::getDroppedLines()) + "\n";
+
+    return text.toUtf8();
+}
+
+bool MetricsManager::dumpMetrics(const QString &fileName)
+{
+    // Written aside then renamed, so that a scraper never reads a partial file
+    QString partialFileName = fileName + ".tmp";
+    QFile file(partialFileName);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        ERROR_LOG(LOG_GENERAL, "[Metrics] Can't write " + fileName);
+        return false;
+    }
+
+    file.write(toPrometheusText());
+    file.close();
+    QFile::remove(fileName);
+
+    return QFile::rename(partialFileName, fileName);
+}
+
+const QString MetricsManager::getMetricsFileName()
+{
+    return MetricsFileName;
+}
+
+QString MetricsManager::getSocketName()
+{
+#ifdef Q_OS_WIN
+    QString user = QString::fromLocal8Bit(qgetenv("USERNAME"));
+#else
+    QString user = QString::fromLocal8Bit(qgetenv("USER"));
+#endif
+
+    return QString(METRICS_SOCKET_NAME) + "-" + user;
+}
+
+void MetricsManager::dumpOnExit()
+{
+    dumpMetrics(MetricsFileName);
+}
@@ -0,0 +1,126 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#ifndef METRICSMANAGER_H
+#define METRICSMANAGER_H
+
+#include <QString>
+#include <QByteArray>
+#include <QMutex>
+
+#include "config/appconfig.h"
+
+class MetricsServer;
+
+/// Counters, only increasing
+enum MetricCounter
+{
+    METRIC_BYTES_SENT,
+    METRIC_BYTES_RECEIVED,
+    METRIC_DISCOVERY_DATAGRAMS,
+    METRIC_COUNTER_COUNT
+};
+
+/// Histograms, in seconds or in bytes per second
+enum MetricHistogram
+{
+    METRIC_TRANSFER_THROUGHPUT,
+    METRIC_TIME_TO_FIRST_BYTE,
+    METRIC_ACK_RTT,
+    METRIC_RESOLVER_LATENCY,
+    METRIC_HISTORY_PERSISTENCE,
+    METRIC_HISTOGRAM_COUNT
+};
+
+/**
+  * @class MetricsManager
+  *
+  * Registry of the counters and histograms, fed from any thread
+  * The metrics are exported in the Prometheus text format, on a local socket
+  * and in a file written when the application quits, if SettingsManager::isMetricsEnabled()
+  */
+class MetricsManager
+{
+public:
+    /**
+      * Start the local endpoint if the metrics are enabled
+      */
+    static void start();
+    /**
+      * Increment a counter
+      *
+      * @param counter Incremented counter
+      * @param value Value added to the counter
+      */
+    static void increment(MetricCounter counter, qint64 value = 1);
+    /**
+      * Record a value in a histogram
+      *
+      * @param histogram Histogram of the value
+      * @param value Seconds or bytes per second, depending on the histogram
+      */
+    static void observe(MetricHistogram histogram, double value);
+    /**
+      * Get all the metrics in the Prometheus text format
+      *
+      * @return The metrics
+      */
+    static QByteArray toPrometheusText();
+    /**
+      * Write all the metrics in the Prometheus text format
+      *
+      * @param fileName Destination file
+      * @return True if the file has been written, false otherwise
+      */
+    static bool dumpMetrics(const QString &fileName);
+    /**
+      * Getter : MetricsFileName
+      *
+      * @return The file written when the application quits
+      */
+    static const QString getMetricsFileName();
+    /**
+      * Get the name of the local socket serving the metrics, one per user
+      *
+      * @return The socket name
+      */
+    static QString getSocketName();
+
+private:
+    /// Metrics file name
+    static const QString MetricsFileName;
+    /// Values of the counters
+    static qint64 Counters[METRIC_COUNTER_COUNT];
+    /// Values in each bucket of the histograms, the last bucket is +Inf
+    static qint64 Buckets[METRIC_HISTOGRAM_COUNT][METRICS_BUCKET_COUNT + 1];
+    /// Sum of the values of the histograms
+    static double Sums[METRIC_HISTOGRAM_COUNT];
+    /// Mutex for the metrics
+    static QMutex Mutex;
+    /// Local endpoint
+    static MetricsServer *Server;
+
+    /**
+      * Write the metrics to MetricsFileName when the application quits
+      */
+    static void dumpOnExit();
+};
+
+#endif // METRICSMANAGER_H
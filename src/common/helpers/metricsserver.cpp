@@ -0,0 +1,55 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#include "metricsserver.h"
+#include "metricsmanager.h"
+
+#include <QLocalSocket>
+
+MetricsServer::MetricsServer(QObject *parent) :
+    QObject(parent),
+    _server(this)
+{
+    _server.setSocketOptions(QLocalServer::UserAccessOption);
+    connect(&_server, SIGNAL(newConnection()), this, SLOT(onNewConnection()));
+}
+
+bool MetricsServer::listen(const QString &name)
+{
+    if (_server.listen(name))
+        return true;
+
+    QLocalServer::removeServer(name);
+
+    return _server.listen(name);
+}
+
+void MetricsServer::onNewConnection()
+{
+    while (_server.hasPendingConnections())
+    {
+        QLocalSocket *socket = _server.nextPendingConnection();
+
+        connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+        socket->write(MetricsManager::toPrometheusText());
+        // Closed once the metrics are written
+        socket->disconnectFromServer();
+    }
+}
@@ -0,0 +1,59 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <QObject>
+#include <QLocalServer>
+
+/**
+  * @class MetricsServer
+  *
+  * Local socket answering each connection with the metrics, then closing it
+  * Only the current user can connect, nothing is reachable from the network
+  */
+class MetricsServer : public QObject
+{
+    Q_OBJECT
+public:
+    /// Constructor
+    MetricsServer(QObject *parent = 0);
+
+    /**
+      * Listen on a local socket, replacing a socket left by a crashed instance
+      *
+      * @param name Name of the local socket
+      * @return True if the socket is listening, false otherwise
+      */
+    bool listen(const QString &name);
+
+private slots:
+    /**
+      * Send the metrics to the pending connections
+      */
+    void onNewConnection();
+
+private:
+    /// Local server
+    QLocalServer _server;
+};
+
+#endif // METRICSSERVER_H
@@ -0,0 +1,76 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#include "resumejournal.h"
+#include "appconfig.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDataStream>
+
+const quint32 ResumeJournal::Version = 1;
+
+QString ResumeJournal::journalPath(const QString &filePath)
+{
+    return filePath + RESUME_EXTENSION;
+}
+
+qint64 ResumeJournal::getResumeOffset(const QString &filePath, const QString &uid, qint64 fileSize, qint64 fileDate)
+{
+    QFile file(journalPath(filePath));
+    QFileInfo partialFile(filePath);
+    quint32 version;
+    QString journalUid, journalName;
+    qint64 journalSize, journalDate, offset;
+
+    if (!partialFile.exists() || !file.open(QIODevice::ReadOnly))
+        return 0;
+
+    QDataStream in(&file);
+    in >> version >> journalUid >> journalName >> journalSize >> journalDate >> offset;
+    file.close();
+
+    if (in.status() != QDataStream::Ok || version != Version
+            || journalUid != uid || journalName != partialFile.fileName()
+            || journalSize != fileSize || journalDate != fileDate
+            || offset <= 0 || offset >= fileSize || partialFile.size() < offset)
+        return 0;
+
+    return offset;
+}
+
+bool ResumeJournal::save(const QString &filePath, const QString &uid, qint64 fileSize, qint64 fileDate, qint64 offset)
+{
+    QFile file(journalPath(filePath));
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    QDataStream out(&file);
+    out << Version << uid << QFileInfo(filePath).fileName() << fileSize << fileDate << offset;
+    file.close();
+
+    return (out.status() == QDataStream::Ok);
+}
+
+void ResumeJournal::remove(const QString &filePath)
+{
+    QFile::remove(journalPath(filePath));
+}
@@ -0,0 +1,76 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#ifndef RESUMEJOURNAL_H
+#define RESUMEJOURNAL_H
+
+#include <QString>
+
+/**
+ * @class ResumeJournal
+ *
+ * Sidecar file kept next to a partially received file.
+ * It describes the transfer (sender, name, size, modification date)
+ * and the offset up to which the partial file is known to be written.
+ */
+class ResumeJournal
+{
+public:
+    /**
+     * Retrieve the offset from which a transfer can be resumed
+     *
+     * @param filePath Path of the partial file
+     * @param uid Uid of the sender
+     * @param fileSize Size of the complete file
+     * @param fileDate Modification date of the file on the sender (ms since epoch)
+     * @return The offset to resume from, or 0 if the journal does not match
+     */
+    static qint64 getResumeOffset(const QString &filePath, const QString &uid, qint64 fileSize, qint64 fileDate);
+    /**
+     * Write the journal of a partial file
+     *
+     * @param filePath Path of the partial file
+     * @param uid Uid of the sender
+     * @param fileSize Size of the complete file
+     * @param fileDate Modification date of the file on the sender (ms since epoch)
+     * @param offset Number of bytes written in the partial file
+     * @return True if the journal is written, false otherwise
+     */
+    static bool save(const QString &filePath, const QString &uid, qint64 fileSize, qint64 fileDate, qint64 offset);
+    /**
+     * Remove the journal of a file, if any
+     *
+     * @param filePath Path of the file
+     */
+    static void remove(const QString &filePath);
+
+private:
+    /// Journal format version
+    static const quint32 Version;
+
+    /**
+     * Path of the journal for a file
+     *
+     * @param filePath Path of the file
+     */
+    static QString journalPath(const QString &filePath);
+};
+
+#endif // RESUMEJOURNAL_H
@@ -0,0 +1,116 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#include "sendpump.h"
+#include "filehelper.h"
+#include "logmanager.h"
+#include "metricsmanager.h"
+#include "appconfig.h"
+
+#include <QFile>
+
+SendPump::SendPump(qint64 chunkSize) :
+    _zeroCopy(true),
+    _chunkSizer(chunkSize)
+{
+}
+
+SendPump::Status SendPump::pump(QIODevice *source, QTcpSocket *socket, qint64 &position, qint64 end, qint64 highWatermark)
+{
+    QFile *file = qobject_cast<QFile*>(source);
+
+    if (_zeroCopy && file && position < end)
+    {
+        // Zero copy only once the socket buffer is empty, so that the bytes stay in order
+        if (socket->bytesToWrite() > 0)
+            return Waiting;
+
+        qint64 sent = FileHelper::sendFile(*file, position, end - position, socket->socketDescriptor());
+
+        if (sent < 0)
+        {
+            WARNING_LOG(LOG_TRANSFER, "[Server] Zero copy unavailable, buffered sending");
+            _zeroCopy = false;
+        }
+        else
+        {
+            position += sent;
+            MetricsManager::increment(METRIC_BYTES_SENT, sent);
+            highWatermark = ZERO_COPY_WAKEUP_BUFFER;
+        }
+
+        file->seek(position);
+    }
+
+    if (position == end)
+        return Finished;
+
+    // Only read from the disk once the socket went below the low watermark
+    if (socket->bytesToWrite() > highWatermark / 2)
+        return Waiting;
+
+    if (!_zeroCopy || !file)
+        _chunkSizer.measure(socket->bytesToWrite());
+
+    qint64 chunkSize = _chunkSizer.getChunkSize();
+
+    if (_sendBuffer.size() < chunkSize)
+        _sendBuffer.resize(chunkSize);
+
+    qint64 written = 0;
+    Status status = Waiting;
+
+    while (position < end && socket->bytesToWrite() < highWatermark)
+    {
+        qint64 size = qMin(chunkSize, end - position);
+        qint64 read = source->read(_sendBuffer.data(), qMin(size, highWatermark - socket->bytesToWrite()));
+
+        if (read <= 0)
+        {
+            status = Failed;
+            break;
+        }
+
+        qint64 chunkWritten = socket->write(_sendBuffer.constData(), read);
+
+        position += chunkWritten;
+        written += chunkWritten;
+    }
+    MetricsManager::increment(METRIC_BYTES_SENT, written);
+
+    _chunkSizer.setQueued(socket->bytesToWrite());
+
+    return status;
+}
+
+void SendPump::setZeroCopy(bool zeroCopy)
+{
+    _zeroCopy = zeroCopy;
+}
+
+void SendPump::resetChunkSize(qint64 chunkSize)
+{
+    _chunkSizer.reset(chunkSize);
+}
+
+const ChunkSizer &SendPump::getChunkSizer() const
+{
+    return _chunkSizer;
+}
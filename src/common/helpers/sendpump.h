@@ -0,0 +1,90 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#ifndef SENDPUMP_H
+#define SENDPUMP_H
+
+#include <QIODevice>
+#include <QTcpSocket>
+#include <QByteArray>
+
+#include "chunksizer.h"
+
+/**
+ * @class SendPump
+ *
+ * Moves a byte range of a device to a socket, each time the socket asks for more data.
+ * Files are sent with FileHelper::sendFile while it works, the other devices are read
+ * by chunks sized by a ChunkSizer. The disk is only read once the socket went below
+ * half of the high watermark, and the socket never holds more than the high watermark.
+ */
+class SendPump
+{
+public:
+    /// Result of a pump
+    enum Status {
+        Waiting,    ///< Part of the range is still to be written, wait for the socket
+        Finished,   ///< The whole range has been written to the socket
+        Failed      ///< The device cannot be read
+    };
+
+    /**
+     * Constructor
+     *
+     * @param chunkSize Initial chunk size
+     */
+    explicit SendPump(qint64 chunkSize);
+
+    /**
+     * Write the next part of a range to the socket
+     *
+     * @param source Device read, sent with FileHelper::sendFile if it is a QFile
+     * @param socket Socket written
+     * @param position Position of the next byte to send in the source, moved forward
+     * @param end End of the range in the source
+     * @param highWatermark Bytes that may be queued in the socket
+     * @return The state of the range
+     */
+    Status pump(QIODevice *source, QTcpSocket *socket, qint64 &position, qint64 end, qint64 highWatermark);
+    /**
+     * Setter : _zeroCopy
+     */
+    void setZeroCopy(bool zeroCopy);
+    /**
+     * Restart the chunk size measures
+     *
+     * @param chunkSize Initial chunk size
+     */
+    void resetChunkSize(qint64 chunkSize);
+    /**
+     * Getter : _chunkSizer
+     */
+    const ChunkSizer &getChunkSizer() const;
+
+private:
+    /// Send the files with FileHelper::sendFile, disabled once it fails
+    bool _zeroCopy;
+    /// Reusable buffer between the source and the socket
+    QByteArray _sendBuffer;
+    /// Size of the chunks read from the source, adapted to the link
+    ChunkSizer _chunkSizer;
+};
+
+#endif // SENDPUMP_H
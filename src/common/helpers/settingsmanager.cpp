@@ -21,6 +21,7 @@
 #include "settingsmanager.h"
 #include "filehelper.h"
 #include "appconfig.h"
+#include "logmanager.h"
 
 #include <QFile>
 #include <QHostInfo>
@@ -34,13 +35,24 @@
 #include <QDesktopServices>
 
 #define MAX_DEVICES "MaxDevices"
+#define MAX_SESSIONS "MaxSessions"
+#define MAX_STREAMS "MaxStreams"
+#define SEND_BUFFER_SIZE "SendBufferSize"
+#define MIN_CHUNK_SIZE "MinChunkSize"
+#define MAX_CHUNK_SIZE "MaxChunkSize"
 #define TRAY_ICON_ENABLED "TrayIconEnabled"
 #define WIDGET_ENABLED "WidgetEnabled"
 #define AVAILABLE_DEVICE_COLOR "AvailableDeviceColor"
 #define UNAVAILABLE_DEVICE_COLOR "UnavailableDeviceColor"
 #define LOG_ENABLED "LogEnabled"
+#define LOG_LEVEL "LogLevel"
+#define LOG_CATEGORIES "LogCategories"
+#define TRACE_ENABLED "TraceEnabled"
+#define METRICS_ENABLED "MetricsEnabled"
 #define START_SERVICE_AT_LAUNCH "StartServiceAtLaunch"
 #define AUTO_OPEN_FILES "AutoOpenFiles"
+#define FAST_RECEIVE "FastReceive"
+#define PERSISTENT_SESSIONS "PersistentSessions"
 #define SERVICE_DEVICE_NAME "ServiceDeviceName"
 #define DESTINATION_FOLDER "DestinationFolder"
 #define DEVICE_UID "UID"
@@ -53,15 +65,30 @@
 
 #define WIDGET_DISPLAY "_DISPLAY"
 #define WIDGET_POS "_POS"
+#define STREAM_COUNT "_STREAMS"
+#define CHUNK_SIZE "_CHUNK"
+#define LAST_ADDRESS "_ADDRESS"
 
 int SettingsManager::HistoryVersion = -1;
 bool SettingsManager::StartMinimized = false;
 bool SettingsManager::LogEnabled = true;
+int SettingsManager::LogLevel = LOG_LEVEL_DEBUG;
+int SettingsManager::LogCategories = LOG_ALL_CATEGORIES;
+bool SettingsManager::TraceEnabled = false;
+bool SettingsManager::MetricsEnabled = false;
+bool SettingsManager::ReadOnly = false;
 bool SettingsManager::WidgetForeground = true;
 int SettingsManager::MaxDevices = 10;
+int SettingsManager::MaxSessions = 8;
+int SettingsManager::MaxStreams = 4;
+int SettingsManager::SendBufferSize = 4 * 1024 * 1024;
+int SettingsManager::MinChunkSize = 16 * 1024;
+int SettingsManager::MaxChunkSize = 8 * 1024 * 1024;
 bool SettingsManager::TrayIconEnabled = true;
 bool SettingsManager::StartServiceAtLaunch = true;
 bool SettingsManager::AutoOpenFiles = true;
+bool SettingsManager::FastReceive = true;
+bool SettingsManager::PersistentSessions = true;
 bool SettingsManager::WidgetEnabled = true;
 bool SettingsManager::FirstLaunch = true;
 bool SettingsManager::SearchUpdateAtLaunch = true;
@@ -83,6 +110,52 @@ int SettingsManager::getMaxDevices()
     return MaxDevices;
 }
 
+int SettingsManager::getMaxSessions()
+{
+    return MaxSessions;
+}
+
+int SettingsManager::getMaxStreams()
+{
+    return MaxStreams;
+}
+
+int SettingsManager::getSendBufferSize()
+{
+    return SendBufferSize;
+}
+
+int SettingsManager::getMinChunkSize()
+{
+    return MinChunkSize;
+}
+
+int SettingsManager::getMaxChunkSize()
+{
+    return MaxChunkSize;
+}
+
+int SettingsManager::getChunkSize(const QString &uid)
+{
+    QSettings settings(FileName, QSettings::IniFormat);
+
+    return settings.value(uid + CHUNK_SIZE, READ_FILE_BUFFER).toInt();
+}
+
+QString SettingsManager::getLastAddress(const QString &uid)
+{
+    QSettings settings(FileName, QSettings::IniFormat);
+
+    return settings.value(uid + LAST_ADDRESS).toString();
+}
+
+int SettingsManager::getStreamCount(const QString &uid)
+{
+    QSettings settings(FileName, QSettings::IniFormat);
+
+    return settings.value(uid + STREAM_COUNT, MaxStreams).toInt();
+}
+
 bool SettingsManager::shouldStartAtBoot()
 {
 #if defined(Q_WS_WIN) || defined(Q_OS_WIN32)
@@ -147,6 +220,16 @@ bool SettingsManager::isAutoOpenFilesEnabled()
     return AutoOpenFiles;
 }
 
+bool SettingsManager::isFastReceiveEnabled()
+{
+    return FastReceive;
+}
+
+bool SettingsManager::isPersistentSessionsEnabled()
+{
+    return PersistentSessions;
+}
+
 bool SettingsManager::isServiceStartedAtlaunch()
 {
     return StartServiceAtLaunch;
@@ -162,6 +245,31 @@ bool SettingsManager::isLogEnabled()
     return LogEnabled;
 }
 
+int SettingsManager::getLogLevel()
+{
+    return LogLevel;
+}
+
+int SettingsManager::getLogCategories()
+{
+    return LogCategories;
+}
+
+bool SettingsManager::isTraceEnabled()
+{
+    return TraceEnabled;
+}
+
+bool SettingsManager::isMetricsEnabled()
+{
+    return MetricsEnabled;
+}
+
+bool SettingsManager::isReadOnly()
+{
+    return ReadOnly;
+}
+
 bool SettingsManager::isWidgetEnabled()
 {
     return WidgetEnabled;
@@ -211,13 +319,24 @@ void SettingsManager::rewriteSettings()
     settings.setValue(FIRST_LAUNCH, FirstLaunch);
     settings.setValue(START_MINIMIZED, StartMinimized);
     settings.setValue(MAX_DEVICES, MaxDevices);
+    settings.setValue(MAX_SESSIONS, MaxSessions);
+    settings.setValue(MAX_STREAMS, MaxStreams);
+    settings.setValue(SEND_BUFFER_SIZE, SendBufferSize);
+    settings.setValue(MIN_CHUNK_SIZE, MinChunkSize);
+    settings.setValue(MAX_CHUNK_SIZE, MaxChunkSize);
     settings.setValue(TRAY_ICON_ENABLED, TrayIconEnabled);
     settings.setValue(WIDGET_ENABLED, WidgetEnabled);
     settings.setValue(AVAILABLE_DEVICE_COLOR, AvailableDeviceColor);
     settings.setValue(UNAVAILABLE_DEVICE_COLOR, UnavailableDeviceColor);
     settings.setValue(LOG_ENABLED, LogEnabled);
+    settings.setValue(LOG_LEVEL, LogLevel);
+    settings.setValue(LOG_CATEGORIES, LogCategories);
+    settings.setValue(TRACE_ENABLED, TraceEnabled);
+    settings.setValue(METRICS_ENABLED, MetricsEnabled);
     settings.setValue(START_SERVICE_AT_LAUNCH, StartServiceAtLaunch);
     settings.setValue(AUTO_OPEN_FILES, AutoOpenFiles);
+    settings.setValue(FAST_RECEIVE, FastReceive);
+    settings.setValue(PERSISTENT_SESSIONS, PersistentSessions);
     settings.setValue(SERVICE_DEVICE_NAME, ServiceDeviceName);
     settings.setValue(DESTINATION_FOLDER, DestinationFolder);
     settings.setValue(DEVICE_UID, DeviceUID);
@@ -233,11 +352,22 @@ void SettingsManager::loadSettings()
     HistoryVersion  = settings.value(HISTORY_VERSION, HistoryVersion).toInt();
     StartMinimized = settings.value(START_MINIMIZED, StartMinimized).toBool();
     MaxDevices = settings.value(MAX_DEVICES, MaxDevices).toInt();
+    MaxSessions = settings.value(MAX_SESSIONS, MaxSessions).toInt();
+    MaxStreams = settings.value(MAX_STREAMS, MaxStreams).toInt();
+    SendBufferSize = settings.value(SEND_BUFFER_SIZE, SendBufferSize).toInt();
+    MinChunkSize = settings.value(MIN_CHUNK_SIZE, MinChunkSize).toInt();
+    MaxChunkSize = settings.value(MAX_CHUNK_SIZE, MaxChunkSize).toInt();
     TrayIconEnabled = settings.value(TRAY_ICON_ENABLED, TrayIconEnabled).toBool();
     StartServiceAtLaunch = settings.value(START_SERVICE_AT_LAUNCH, StartServiceAtLaunch).toBool();
     WidgetForeground = settings.value(WIDGET_FOREGROUND, WidgetForeground).toBool();
     LogEnabled = settings.value(LOG_ENABLED, LogEnabled).toBool();
+    LogLevel = settings.value(LOG_LEVEL, LogLevel).toInt();
+    LogCategories = settings.value(LOG_CATEGORIES, LogCategories).toInt();
+    TraceEnabled = settings.value(TRACE_ENABLED, TraceEnabled).toBool();
+    MetricsEnabled = settings.value(METRICS_ENABLED, MetricsEnabled).toBool();
     AutoOpenFiles = settings.value(AUTO_OPEN_FILES, AutoOpenFiles).toBool();
+    FastReceive = settings.value(FAST_RECEIVE, FastReceive).toBool();
+    PersistentSessions = settings.value(PERSISTENT_SESSIONS, PersistentSessions).toBool();
     WidgetEnabled = settings.value(WIDGET_ENABLED, WidgetEnabled).toBool();
     AvailableDeviceColor = settings.value(AVAILABLE_DEVICE_COLOR, AvailableDeviceColor).toString();
     UnavailableDeviceColor = settings.value(UNAVAILABLE_DEVICE_COLOR, UnavailableDeviceColor).toString();
@@ -302,6 +432,18 @@ void SettingsManager::setAutoOpenFiles(bool enabled)
     writeSetting(AUTO_OPEN_FILES, AutoOpenFiles);
 }
 
+void SettingsManager::setFastReceive(bool enabled)
+{
+    FastReceive = enabled;
+    writeSetting(FAST_RECEIVE, FastReceive);
+}
+
+void SettingsManager::setPersistentSessions(bool enabled)
+{
+    PersistentSessions = enabled;
+    writeSetting(PERSISTENT_SESSIONS, PersistentSessions);
+}
+
 void SettingsManager::setWidgetForeground(bool enabled)
 {
     WidgetForeground = enabled;
@@ -320,6 +462,51 @@ void SettingsManager::setMaxDevices(int maxDevices)
     writeSetting(MAX_DEVICES, MaxDevices);
 }
 
+void SettingsManager::setMaxSessions(int maxSessions)
+{
+    MaxSessions = maxSessions;
+    writeSetting(MAX_SESSIONS, MaxSessions);
+}
+
+void SettingsManager::setMaxStreams(int maxStreams)
+{
+    MaxStreams = maxStreams;
+    writeSetting(MAX_STREAMS, MaxStreams);
+}
+
+void SettingsManager::setSendBufferSize(int sendBufferSize)
+{
+    SendBufferSize = sendBufferSize;
+    writeSetting(SEND_BUFFER_SIZE, SendBufferSize);
+}
+
+void SettingsManager::setMinChunkSize(int minChunkSize)
+{
+    MinChunkSize = minChunkSize;
+    writeSetting(MIN_CHUNK_SIZE, MinChunkSize);
+}
+
+void SettingsManager::setMaxChunkSize(int maxChunkSize)
+{
+    MaxChunkSize = maxChunkSize;
+    writeSetting(MAX_CHUNK_SIZE, MaxChunkSize);
+}
+
+void SettingsManager::setChunkSize(const QString &uid, int chunkSize)
+{
+    writeSetting(uid + CHUNK_SIZE, chunkSize);
+}
+
+void SettingsManager::setLastAddress(const QString &uid, const QString &address)
+{
+    writeSetting(uid + LAST_ADDRESS, address);
+}
+
+void SettingsManager::setStreamCount(const QString &uid, int streamCount)
+{
+    writeSetting(uid + STREAM_COUNT, streamCount);
+}
+
 void SettingsManager::setFirstLaunch(bool firstLaunch)
 {
     FirstLaunch = firstLaunch;
@@ -332,6 +519,35 @@ void SettingsManager::setLogEnabled(bool enabled)
     writeSetting(LOG_ENABLED, LogEnabled);
 }
 
+void SettingsManager::setLogLevel(int level)
+{
+    LogLevel = level;
+    writeSetting(LOG_LEVEL, LogLevel);
+}
+
+void SettingsManager::setLogCategories(int categories)
+{
+    LogCategories = categories;
+    writeSetting(LOG_CATEGORIES, LogCategories);
+}
+
+void SettingsManager::setTraceEnabled(bool enabled)
+{
+    TraceEnabled = enabled;
+    writeSetting(TRACE_ENABLED, TraceEnabled);
+}
+
+void SettingsManager::setMetricsEnabled(bool enabled)
+{
+    MetricsEnabled = enabled;
+    writeSetting(METRICS_ENABLED, MetricsEnabled);
+}
+
+void SettingsManager::setReadOnly(bool readOnly)
+{
+    ReadOnly = readOnly;
+}
+
 void SettingsManager::setTrayIconEnabled(bool enabled)
 {
     TrayIconEnabled = enabled;
@@ -370,6 +586,9 @@ void SettingsManager::setUnavailableDeviceColor(const QString &color)
 
 void SettingsManager::writeSetting(const QString &key, const QVariant &variant)
 {
+    if (ReadOnly)
+        return;
+
     QSettings settings(FileName, QSettings::IniFormat);
 
     settings.setValue(key, variant);
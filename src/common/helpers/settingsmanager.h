@@ -44,6 +44,47 @@ public:
       * Getter : MaxDevices
       */
     static int getMaxDevices();
+    /**
+      * Getter : MaxSessions
+      */
+    static int getMaxSessions();
+    /**
+      * Getter : MaxStreams
+      */
+    static int getMaxStreams();
+    /**
+      * Number of connections used to send a large file to a device
+      *
+      * @param uid Device uid
+      * @return Stream count of the device, MaxStreams if it has not been tuned
+      */
+    static int getStreamCount(const QString &uid);
+    /**
+      * Getter : SendBufferSize
+      */
+    static int getSendBufferSize();
+    /**
+      * Getter : MinChunkSize
+      */
+    static int getMinChunkSize();
+    /**
+      * Getter : MaxChunkSize
+      */
+    static int getMaxChunkSize();
+    /**
+      * Chunk size the last transfer to a device converged to
+      *
+      * @param uid Device uid
+      * @return Chunk size of the device, READ_FILE_BUFFER if it never received a file
+      */
+    static int getChunkSize(const QString &uid);
+    /**
+      * Address a device was last reached at
+      *
+      * @param uid Device uid
+      * @return Address as a string, empty if the device was never reached
+      */
+    static QString getLastAddress(const QString &uid);
     /**
       * Getter : HistoryVersion
       */
@@ -72,6 +113,26 @@ public:
       * Getter : LogEnabled
       */
     static bool isLogEnabled();
+    /**
+      * Getter : LogLevel
+      */
+    static int getLogLevel();
+    /**
+      * Getter : LogCategories
+      */
+    static int getLogCategories();
+    /**
+      * Getter : TraceEnabled
+      */
+    static bool isTraceEnabled();
+    /**
+      * Getter : MetricsEnabled
+      */
+    static bool isMetricsEnabled();
+    /**
+      * Getter : ReadOnly
+      */
+    static bool isReadOnly();
     /**
      * Getter : SearchUpdateAtLaunch
      */
@@ -80,6 +141,14 @@ public:
      * Getter : AutoOpenFiles
      */
     static bool isAutoOpenFilesEnabled();
+    /**
+     * Getter : FastReceive
+     */
+    static bool isFastReceiveEnabled();
+    /**
+     * Getter : PersistentSessions
+     */
+    static bool isPersistentSessionsEnabled();
     /**
      * Getter : WidgetPosition
      */
@@ -136,6 +205,38 @@ public:
       * Setter : MaxDevices
       */
     static void setMaxDevices(int maxDevices);
+    /**
+      * Setter : MaxSessions
+      */
+    static void setMaxSessions(int maxSessions);
+    /**
+      * Setter : MaxStreams
+      */
+    static void setMaxStreams(int maxStreams);
+    /**
+      * Set the number of connections used to send a large file to a device
+      */
+    static void setStreamCount(const QString &uid, int streamCount);
+    /**
+      * Setter : SendBufferSize
+      */
+    static void setSendBufferSize(int sendBufferSize);
+    /**
+      * Setter : MinChunkSize
+      */
+    static void setMinChunkSize(int minChunkSize);
+    /**
+      * Setter : MaxChunkSize
+      */
+    static void setMaxChunkSize(int maxChunkSize);
+    /**
+      * Record the chunk size a transfer to a device converged to
+      */
+    static void setChunkSize(const QString &uid, int chunkSize);
+    /**
+      * Record the address a device has been reached at
+      */
+    static void setLastAddress(const QString &uid, const QString &address);
     /**
       * Setter : MaxSizeFile
       */
@@ -160,6 +261,14 @@ public:
       * Setter : AutoOpenFiles
       */
     static void setAutoOpenFiles(bool enabled);
+    /**
+      * Setter : FastReceive
+      */
+    static void setFastReceive(bool enabled);
+    /**
+      * Setter : PersistentSessions
+      */
+    static void setPersistentSessions(bool enabled);
     /**
      * Setter : StartMinimized
      */
@@ -188,6 +297,31 @@ public:
       * Setter : LogEnabled
       */
     static void setLogEnabled(bool enabled);
+    /**
+      * Setter : LogLevel
+      *
+      * @param level Lowest LogLevel written
+      */
+    static void setLogLevel(int level);
+    /**
+      * Setter : LogCategories
+      *
+      * @param categories Combination of the LogCategory written
+      */
+    static void setLogCategories(int categories);
+    /**
+      * Setter : TraceEnabled
+      */
+    static void setTraceEnabled(bool enabled);
+    /**
+      * Setter : MetricsEnabled
+      */
+    static void setMetricsEnabled(bool enabled);
+    /**
+      * Setter : ReadOnly
+      * The settings changed afterwards are kept in memory only, the settings file is left untouched
+      */
+    static void setReadOnly(bool readOnly);
     /**
       * Setter : HistoryVersion
       */
@@ -232,6 +366,16 @@ public:
 private:
     /// The maximum number of devices the application will show
     static int MaxDevices;
+    /// The maximum number of simultaneous incoming transfers
+    static int MaxSessions;
+    /// The maximum number of connections for a single file transfer
+    static int MaxStreams;
+    /// Bytes of file data a device may queue in its sockets (high watermark)
+    static int SendBufferSize;
+    /// Lower bound of the adaptive chunk size
+    static int MinChunkSize;
+    /// Upper bound of the adaptive chunk size
+    static int MaxChunkSize;
     /**
       * Is the tray enabled
       * If the tray is desabled, the widget setting will be ignored
@@ -255,6 +399,16 @@ private:
     static const QString AppName;
     /// Log enabled
     static bool LogEnabled;
+    /// Lowest level of the logged lines
+    static int LogLevel;
+    /// Categories of the logged lines
+    static int LogCategories;
+    /// Record the transfer phases for a trace export
+    static bool TraceEnabled;
+    /// Expose the metrics on the local endpoint and in the metrics file
+    static bool MetricsEnabled;
+    /// Do not write the settings file (benchmark)
+    static bool ReadOnly;
     /// The maximum size of sending file in Mo
     static int MaxFileSize;
     /// Start the Client service at program launch
@@ -263,6 +417,10 @@ private:
     static bool SearchUpdateAtLaunch;
     /// Auto open files on received
     static bool AutoOpenFiles;
+    /// Preallocate received files and write them through a reusable buffer
+    static bool FastReceive;
+    /// Keep the connection to a device open between transfers
+    static bool PersistentSessions;
     /// Unique ID
     static QString DeviceUID;
     /// Version ignored
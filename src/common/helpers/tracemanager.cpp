@@ -0,0 +1,214 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#include "tracemanager.h"
+#include "settingsmanager.h"
+#include "logmanager.h"
+#include "appconfig.h"
+#include "helpers/filehelper.h"
+
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QMutexLocker>
+#include <QFile>
+
+const QString TraceManager::TraceFileName = FileHelper::getFileStorageLocation() + "/" + TRACE_FILE;
+QElapsedTimer TraceManager::Clock;
+QList<QJsonObject> TraceManager::Events;
+QHash<QString, int> TraceManager::Tracks;
+int TraceManager::NextTrack = 1;
+int TraceManager::DroppedEvents = 0;
+int TraceManager::Spans = 0;
+QMutex TraceManager::Mutex;
+
+void TraceManager::start()
+{
+    if (!Clock.isValid())
+    {
+        Clock.start();
+        qAddPostRoutine(TraceManager::exportOnExit);
+    }
+}
+
+bool TraceManager::isEnabled()
+{
+    return SettingsManager::isTraceEnabled();
+}
+
+qint64 TraceManager::now()
+{
+    return Clock.isValid() ? Clock.nsecsElapsed() / 1000 : 0;
+}
+
+int TraceManager::getTrack(const QString &name)
+{
+    QMutexLocker locker(&Mutex);
+    int track = Tracks.value(name);
+
+    if (track == 0)
+    {
+        QJsonObject event;
+        QJsonObject args;
+
+        track = NextTrack++;
+        Tracks.insert(name, track);
+
+        // Name the track in the trace viewer
+        args.insert("name", name);
+        event.insert("name", QString("thread_name"));
+        event.insert("ph", QString("M"));
+        event.insert("pid", QCoreApplication::applicationPid());
+        event.insert("tid", track);
+        event.insert("args", args);
+
+        // Every session has its own track, their names are capped as the spans
+        if (Events.size() < TRACE_MAX_EVENTS)
+            Events.append(event);
+        else
+            ++DroppedEvents;
+    }
+
+    return track;
+}
+
+void TraceManager::releaseTrack(const QString &name)
+{
+    QMutexLocker locker(&Mutex);
+
+    Tracks.remove(name);
+}
+
+void TraceManager::addSpan(int track, const char *category, const QString &name,
+                           qint64 start, const QString &detail)
+{
+    QJsonObject event;
+    qint64 end = now();
+
+    event.insert("name", name);
+    event.insert("cat", QString(category));
+    event.insert("ph", QString("X"));
+    event.insert("ts", start);
+    event.insert("dur", end - start);
+    event.insert("pid", QCoreApplication::applicationPid());
+    event.insert("tid", track);
+    if (!detail.isEmpty())
+    {
+        QJsonObject args;
+
+        args.insert("detail", detail);
+        event.insert("args", args);
+    }
+
+    QMutexLocker locker(&Mutex);
+
+    ++Spans;
+    if (Events.size() < TRACE_MAX_EVENTS)
+        Events.append(event);
+    else
+        ++DroppedEvents;
+}
+
+bool TraceManager::exportTrace(const QString &fileName)
+{
+    QJsonArray events;
+    QJsonObject otherData;
+    QJsonObject trace;
+    QFile file(fileName);
+
+    {
+        QMutexLocker locker(&Mutex);
+
+        foreach (const QJsonObject &event, Events)
+            events.append(event);
+        otherData.insert("droppedEvents", DroppedEvents);
+    }
+
+    trace.insert("traceEvents", events);
+    trace.insert("displayTimeUnit", QString("ms"));
+    trace.insert("otherData", otherData);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        ERROR_LOG(LOG_GENERAL, "[Trace] Can't write " + fileName);
+        return false;
+    }
+
+    file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact));
+    file.close();
+    INFO_LOG(LOG_GENERAL, "[Trace] " + QString::number(events.size()) + " events exported to " + fileName);
+
+    return true;
+}
+
+const QString TraceManager::getTraceFileName()
+{
+    return TraceFileName;
+}
+
+void TraceManager::exportOnExit()
+{
+    bool empty;
+
+    {
+        QMutexLocker locker(&Mutex);
+
+        empty = (Spans == 0);
+    }
+
+    if (!empty)
+        exportTrace(TraceFileName);
+}
+
+TraceSpan::TraceSpan() :
+    _track(0),
+    _category(""),
+    _start(0),
+    _active(false)
+{
+}
+
+void TraceSpan::begin(const QString &track, const char *category, const QString &name,
+                      const QString &detail)
+{
+    _active = TraceManager::isEnabled();
+    if (!_active)
+        return;
+
+    _track = TraceManager::getTrack(track);
+    _category = category;
+    _name = name;
+    _detail = detail;
+    _start = TraceManager::now();
+}
+
+void TraceSpan::end(const QString &detail)
+{
+    if (!_active)
+        return;
+
+    _active = false;
+    TraceManager::addSpan(_track, _category, _name, _start, detail.isEmpty() ? _detail : detail);
+}
+
+bool TraceSpan::isActive() const
+{
+    return _active;
+}
@@ -0,0 +1,169 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#ifndef TRACEMANAGER_H
+#define TRACEMANAGER_H
+
+#include <QString>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QJsonObject>
+#include <QElapsedTimer>
+
+/**
+  * @class TraceManager
+  *
+  * Records timed spans of the transfer phases, from any thread, and exports
+  * them in the Chrome trace format (chrome://tracing, Perfetto)
+  * Recording is enabled by SettingsManager::isTraceEnabled()
+  */
+class TraceManager
+{
+public:
+    /**
+      * Start the trace clock, the trace is exported when the application quits
+      */
+    static void start();
+    /**
+      * Check if the spans are recorded
+      *
+      * @return True if the spans are recorded, false otherwise
+      */
+    static bool isEnabled();
+    /**
+      * Get the current trace time
+      *
+      * @return Microseconds since the trace start
+      */
+    static qint64 now();
+    /**
+      * Get the track of a name, shown as a thread in the trace
+      *
+      * @param name Name of the track
+      * @return The track id
+      */
+    static int getTrack(const QString &name);
+    /**
+      * Forget the track of a name, its spans are kept in the trace
+      * A later getTrack() with the same name creates a new track
+      *
+      * @param name Name of the track
+      */
+    static void releaseTrack(const QString &name);
+    /**
+      * Record a finished span
+      *
+      * @param track Track of the span
+      * @param category Category of the span
+      * @param name Name of the span
+      * @param start Start of the span, from now()
+      * @param detail Optional detail shown with the span
+      */
+    static void addSpan(int track, const char *category, const QString &name,
+                        qint64 start, const QString &detail);
+    /**
+      * Write the recorded spans in the Chrome trace format
+      *
+      * @param fileName Destination file
+      * @return True if the file has been written, false otherwise
+      */
+    static bool exportTrace(const QString &fileName);
+    /**
+      * Getter : TraceFileName
+      *
+      * @return The file written when the application quits
+      */
+    static const QString getTraceFileName();
+
+private:
+    /// Trace file name
+    static const QString TraceFileName;
+    /// Clock of the trace timestamps
+    static QElapsedTimer Clock;
+    /// Recorded events
+    static QList<QJsonObject> Events;
+    /// Track ids by name
+    static QHash<QString, int> Tracks;
+    /// Id of the next track, ids are not reused after a release
+    static int NextTrack;
+    /// Events not recorded because the trace was full
+    static int DroppedEvents;
+    /// Spans ended since the start, recorded or dropped
+    static int Spans;
+    /// Mutex for the events and the tracks
+    static QMutex Mutex;
+
+    /**
+      * Export the trace to TraceFileName when the application quits
+      */
+    static void exportOnExit();
+};
+
+/**
+  * @class TraceSpan
+  *
+  * Span of a transfer phase, may begin and end in different slots
+  */
+class TraceSpan
+{
+public:
+    /// Constructor
+    TraceSpan();
+
+    /**
+      * Begin the span if the trace is enabled
+      *
+      * @param track Name of the track of the span
+      * @param category Category of the span
+      * @param name Name of the span
+      * @param detail Optional detail shown with the span
+      */
+    void begin(const QString &track, const char *category, const QString &name,
+               const QString &detail = QString());
+    /**
+      * End the span and record it, nothing is done if it is not running
+      *
+      * @param detail Optional detail replacing the one given at the beginning
+      */
+    void end(const QString &detail = QString());
+    /**
+      * Check if the span is running
+      *
+      * @return True if the span began and did not end, false otherwise
+      */
+    bool isActive() const;
+
+private:
+    /// Track of the span
+    int _track;
+    /// Category of the span
+    const char *_category;
+    /// Name of the span
+    QString _name;
+    /// Detail of the span
+    QString _detail;
+    /// Start of the span
+    qint64 _start;
+    /// True if the span is running
+    bool _active;
+};
+
+#endif // TRACEMANAGER_H
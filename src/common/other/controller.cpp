@@ -55,7 +55,7 @@ Controller::Controller() :
     _view = new View(&_model);
     _bonjourBrowser = new BonjourServiceBrowser(this);
 
-    connect(&_udpDiscovery, SIGNAL(devicesFound(const QList<Device *> &)), this, SLOT(updateDevices(const QList<Device *> &)));
+    connect(&_udpDiscovery, SIGNAL(devicesFound(const QList<DeviceRecord> &)), this, SLOT(updateDevices(const QList<DeviceRecord> &)));
     connect(&_udpDiscovery, SIGNAL(pongReceived(const QString&)), this, SLOT(onPong(const QString &)));
 
     connect(_bonjourBrowser, SIGNAL(currentBonjourRecordsChanged(const QList<BonjourRecord> &)),
@@ -82,13 +82,17 @@ Controller::Controller() :
             &_service, SLOT(onClearHistory()));
     connect(_view, SIGNAL(serviceNameChanged()),
             &_service, SLOT(onTimerOut()));
-    connect(_view, SIGNAL(cancelIncomingTransfert()),
-            &_service, SLOT(deleteFileReset()));
+    connect(_view, SIGNAL(cancelIncomingTransfert(const HistoryElement&)),
+            &_service, SLOT(cancelIncomingTransfert(const HistoryElement&)));
 
     connect(&_service, SIGNAL(historyChanged(const QList<HistoryElement>&)),
             _view, SLOT(onHistoryChanged(const QList<HistoryElement>&)));
-    connect(&_service, SIGNAL(historyElementProgressUpdated(unsigned)),
-            _view, SLOT(historyElementProgressUpdated(unsigned)));
+    connect(&_service, SIGNAL(historyElementAdded(const HistoryElement&)),
+            _view, SLOT(onHistoryElementAdded(const HistoryElement&)));
+    connect(&_service, SIGNAL(historyElementRemoved(int)),
+            _view, SLOT(onHistoryElementRemoved(int)));
+    connect(&_service, SIGNAL(historyElementProgressUpdated(const HistoryElement&, unsigned)),
+            _view, SLOT(historyElementProgressUpdated(const HistoryElement&, unsigned)));
 
     connect(&_service, SIGNAL(serviceError(ServiceErrorState,bool)),
             _view, SLOT(onServiceError(ServiceErrorState,bool)));
@@ -205,8 +209,8 @@ void Controller::updateRecords(const QList<BonjourRecord> &list)
 
         ++_deviceNeedResolve;
 
-        connect(resolver, SIGNAL(bonjourRecordResolved(Device*)),
-                this, SLOT(updateBonjourDevices(Device*)));
+        connect(resolver, SIGNAL(bonjourRecordResolved(const DeviceRecord&)),
+                this, SLOT(updateBonjourDevices(const DeviceRecord&)));
         connect(resolver, SIGNAL(error(DNSServiceErrorType)),
                 this, SLOT(error(DNSServiceErrorType)));
         connect(resolver, SIGNAL(finish(BonjourServiceResolver*)),
@@ -216,10 +220,10 @@ void Controller::updateRecords(const QList<BonjourRecord> &list)
     }
 }
 
-void Controller::updateBonjourDevices(Device *device)
+void Controller::updateBonjourDevices(const DeviceRecord &record)
 {
     if (_deviceNeedResolve < SettingsManager::getMaxDevices())
-        _model.addDeviceToList(device);
+        _model.addDeviceToList(record);
 }
 
 void Controller::onRevolveEnded(BonjourServiceResolver *resolver)
@@ -235,13 +239,13 @@ void Controller::onRevolveEnded(BonjourServiceResolver *resolver)
     resolver->deleteLater();
 }
 
-void Controller::updateDevices(const QList<Device *> &list)
+void Controller::updateDevices(const QList<DeviceRecord> &list)
 {
     _view->refreshEnded();
     LogManager::appendLine("[Controller] Devices updated by UDP (" + QString::number(list.size()) + ")");
     _model.cleanDetectedBy(DETECTED_BY_UDP);
-    foreach(Device *device, list) {
-        _model.addDeviceToList(device);
+    foreach(const DeviceRecord &record, list) {
+        _model.addDeviceToList(record);
     }
     _model.updateDevices();
     _view->updateDevices();
@@ -299,6 +303,9 @@ void Controller::onNewDeviceCreated(Device *device)
 {
     LogManager::appendLine(QString("[Server] New device created " + device->getName()));
 
+    // Discovered devices stay on this thread until they are kept by the model
+    device->moveToThread(_devicePool.getThread(device->getUID()));
+
     connect(device, SIGNAL(deviceDoNotRespond(Device*)),
             this, SLOT(onDeviceNotResponding(Device*)));
 
@@ -341,7 +348,7 @@ void Controller::connectToDevice(Device *device)
 
 unsigned Controller::getDevicesNumbers()
 {
-    return _model.getDevices().size();
+    return _model.getDevicesCount();
 }
 
 void Controller::onSendFile(const QString &uid, const QList<QUrl> &urls, DataType type)
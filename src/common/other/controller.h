@@ -35,7 +35,7 @@
 #include "model.h"
 #include "udp/udpdiscovery.h"
 #include "threads/servicethread.h"
-#include "threads/devicethread.h"
+#include "threads/devicepool.h"
 #include "updatemanager.h"
 #include "view.h"
 
@@ -166,13 +166,13 @@ private slots:
       *
       * @param list The list of records available
       */
-    void updateDevices(const QList<Device *> &list);
+    void updateDevices(const QList<DeviceRecord> &list);
     /**
      * A new device is discover by Bonjour
      *
-     * @param device Discovered device
+     * @param record Discovered device
      */
-    void updateBonjourDevices(Device *device);
+    void updateBonjourDevices(const DeviceRecord &record);
     /**
       * On device connection needed (click or drop)
       * TCP connection between the server and the device
@@ -214,6 +214,8 @@ private:
     BonjourServiceBrowser *_bonjourBrowser;
     /// Main view of the application
     View *_view;
+    /// Threads running the devices, declared before the model so it outlives the devices
+    DevicePool _devicePool;
     /// Model of the application contains the devices information
     Model _model;
     /// Address resolver by udp
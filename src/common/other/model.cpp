@@ -20,8 +20,6 @@
 
 #include "model.h"
 
-#define DEVICE_NOT_FOUND -1
-
 Model::Model()
 {
 }
@@ -33,95 +31,90 @@ Model::~Model()
 
 void Model::clearDevices()
 {
+    // The devices run on the device pool, they are deleted by their own thread
     foreach (Device *device, _devices)
     {
-        delete device;
+        device->deleteLater();
+    }
+    // Devices created during a discovery round that did not end yet
+    foreach (Device *device, _newDevices)
+    {
+        if (!_devices.contains(device->getUID()))
+            device->deleteLater();
     }
     _devices.clear();
+    _sortedDevices.clear();
+    _newDevices.clear();
 }
 
 void Model::addDevice(Device *device)
 {
-    _devices.push_back(device);
+    _devices.insert(device->getUID(), device);
+    _sortedDevices.insert(getSortKey(device), device);
 }
 
 QList<Device*> Model::getDevices() const
 {
-    return _devices;
+    return _devices.values();
 }
 
-QList<Device*> Model::getSortedDevices()
+int Model::getDevicesCount() const
 {
-    QList<Device*> sortedDevices;
-    bool added;
-
-    foreach(Device *device, _devices)
-    {
-        added = false;
-        if (sortedDevices.isEmpty())
-            sortedDevices.append(device);
-        else
-        {
-            for (int i = 0; i < sortedDevices.size() && !added; ++i)
-            {
-                if (device->getName() <= sortedDevices.at(i)->getName())
-                {
-                    sortedDevices.insert(i, device);
-                    added = true;
-                }
-            }
-            if (!added)
-                sortedDevices.push_back(device);
-        }
-    }
+    return _devices.size();
+}
 
-    return sortedDevices;
+QList<Device*> Model::getSortedDevices() const
+{
+    return _sortedDevices.values();
 }
 
 Device* Model::getDeviceByUID(const QString& uid) const
 {
-    foreach (Device *device, _devices) {
-        if(device->getUID() == uid) {
-            return device;
-        }
-    }
-    return NULL;
+    return _devices.value(uid, NULL);
 }
 
-void Model::addDeviceToList(Device *newDevice)
+void Model::addDeviceToList(const DeviceRecord &record)
 {
-    int recordIndex = index(_newDevices, newDevice);
-
-    if(newDevice->getUID() == SettingsManager::getDeviceUID() || recordIndex != DEVICE_NOT_FOUND) {
-        if (recordIndex != DEVICE_NOT_FOUND) {
-             _newDevices.at(recordIndex)->mergeAddresses(newDevice->getHostInfo());
-             _newDevices.at(recordIndex)->setPort(newDevice->getPort());
-             _newDevices.at(recordIndex)->setVersion(newDevice->getVersion());
+    Device *device = _newDevices.value(record._uid, NULL);
+
+    if(record._uid == SettingsManager::getDeviceUID() || device) {
+        if (device) {
+             device->mergeAddresses(record._hostInfo);
+             device->setPort(record._port);
+             device->setVersion(record._version);
+             device->setFeatures(device->getFeatures() | record._features);
         }
 
-        delete newDevice;
         return;
     }
 
-    recordIndex = index(_devices, newDevice);
-    if (recordIndex != DEVICE_NOT_FOUND)
+    device = _devices.value(record._uid, NULL);
+    if (device)
     {
-        Device *device = _devices.takeAt(recordIndex);
         // We update the current record
+        if (device->getName() != record._name)
+        {
+            _sortedDevices.remove(getSortKey(device));
+            device->setName(record._name);
+            _sortedDevices.insert(getSortKey(device), device);
+        }
 
-        device->setName(newDevice->getName());
-        device->setHostInfo(newDevice->getHostInfo());
-        device->setPort(newDevice->getPort());
-        device->setVersion(newDevice->getVersion());
-        device->setDetectedBy(newDevice->getDetectedBy() | device->getDetectedBy());
-        device->mergeAddresses(newDevice->getHostInfo());
-        _newDevices.push_back(device);
-
-        delete newDevice;
+        device->setHostInfo(record._hostInfo);
+        device->setPort(record._port);
+        device->setVersion(record._version);
+        device->setFeatures(record._features);
+        device->setDetectedBy(record._detectedBy | device->getDetectedBy());
+        _newDevices.insert(record._uid, device);
     }
     else
     {
-        _newDevices.push_back(newDevice);
+        // Only a new uid is worth a Device, with its socket and timers
+        Device *newDevice = new Device(record._name, record._type, record._uid, record._hostInfo, record._port, record._version);
+
+        newDevice->setFeatures(record._features);
+        newDevice->setDetectedBy(record._detectedBy);
+        newDevice->setBonjourRecord(record._bonjourRecord);
+        _newDevices.insert(record._uid, newDevice);
 
         emit newDeviceCreated(newDevice);
     }
@@ -131,8 +124,8 @@ void Model::onDeviceNotResponding(Device *device)
 {
     if (device)
     {
-        _devices.removeOne(device);
-        delete device;
+        removeDevice(device);
+        device->deleteLater();
 
         emit deviceRemoved();
     }
@@ -152,26 +145,36 @@ void Model::updateDevices()
     // In case of a record disappear, look for the connected devices
     foreach (Device *device, _devices)
     {
-        if (!_newDevices.contains(device) && device->getDetectedBy() > 0 || device->isConnected())
-            _newDevices.push_back(_devices.takeAt(_devices.indexOf(device)));
+        if (_newDevices.contains(device->getUID()))
+            continue;
+
+        if (device->getDetectedBy() > 0 || device->isConnected())
+            _newDevices.insert(device->getUID(), device);
+        else
+        {
+            removeDevice(device);
+            device->deleteLater();
+        }
     }
 
-    clearDevices();
-    _devices = _newDevices;
+    // Only the devices created during this round are missing from the registry
+    foreach (Device *device, _newDevices)
+    {
+        if (!_devices.contains(device->getUID()))
+            addDevice(device);
+    }
     _newDevices.clear();
 }
 
-int Model::index(QList<Device *> &lst, Device *device) const
+void Model::removeDevice(Device *device)
 {
-    int deviceIndex = DEVICE_NOT_FOUND;
-
-    for (int i = 0; i < lst.size() && deviceIndex == DEVICE_NOT_FOUND; ++i)
-    {
-        if (lst.at(i)->getUID() == device->getUID())
-        {
-            deviceIndex = i;
-        }
-    }
+    _devices.remove(device->getUID());
+    _sortedDevices.remove(getSortKey(device));
+    _newDevices.remove(device->getUID());
+}
 
-    return deviceIndex;
+QPair<QString, QString> Model::getSortKey(Device *device) const
+{
+    // The uid tells apart the devices with the same name
+    return qMakePair(device->getName(), device->getUID());
 }
@@ -22,12 +22,16 @@
 #define MODEL_H
 
 #include <QList>
+#include <QHash>
+#include <QMap>
+#include <QPair>
 #include <QObject>
 #include <QDebug>
 #include <QStringList>
 
 #include "zeroconf/bonjourrecord.h"
 #include "device.h"
+#include "entities/devicerecord.h"
 #include "helpers/settingsmanager.h"
 #include "helpers/logmanager.h"
 
@@ -35,7 +39,7 @@
   * @class Model
   *
   * MVC Model
-  * Contains the devices
+  * Contains the devices, indexed by uid and sorted by name
   */
 class Model : public QObject
 {
@@ -63,11 +67,15 @@ public:
       */
     QList<Device*> getDevices() const;
     /**
-      * Getter : _devices
+      * Number of devices
+      */
+    int getDevicesCount() const;
+    /**
+      * Getter : _sortedDevices
       *
-      * @return Device list sorted
+      * @return Device list sorted by name
       */
-    QList<Device*> getSortedDevices();
+    QList<Device*> getSortedDevices() const;
     /**
       * Find a device by its name
       *
@@ -77,9 +85,11 @@ public:
     Device* getDeviceByUID(const QString& uid) const;
     /**
      * Add a new device by record. Update the old one if it exists.
+     * A Device is only created for an uid that is not known yet
+     *
      * @param record The device to add
      */
-    void addDeviceToList(Device *newDevice);
+    void addDeviceToList(const DeviceRecord &record);
     /**
      * Reset the detection type
      *
@@ -90,13 +100,6 @@ public:
       * Clear the device list
       */
     void clearDevices();
-    /**
-      * Search a device index from a device
-      *
-      * @param device The device to find
-      * @return The device index or -1 if not found
-      */
-    int index(QList<Device *> &lst, Device *device) const;
     /**
      * Check for old entry and copy the new list to the old one
      */
@@ -123,10 +126,21 @@ public slots:
     void onDeviceNotResponding(Device *device);
 
 private:
-    /// Device list
-    QList<Device*> _devices;
-    /// Tmp device list
-    QList<Device*> _newDevices;
+    /// Devices by uid
+    QHash<QString, Device*> _devices;
+    /// Name index of _devices, kept up to date when a device is added, renamed or removed
+    QMap<QPair<QString, QString>, Device*> _sortedDevices;
+    /// Devices seen during the current discovery round, by uid
+    QHash<QString, Device*> _newDevices;
+
+    /**
+      * Remove a device from the registry and its indexes
+      */
+    void removeDevice(Device *device);
+    /**
+      * Key of a device in the name index
+      */
+    QPair<QString, QString> getSortKey(Device *device) const;
 };
 
 #endif // MODEL_H
@@ -0,0 +1,53 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#include <QHash>
+
+#include "devicepool.h"
+
+DevicePool::DevicePool(int size)
+{
+    if (size <= 0)
+        size = qMax(QThread::idealThreadCount(), 1);
+
+    for (int i = 0; i < size; ++i)
+        _threads.append(new DeviceThread());
+}
+
+DevicePool::~DevicePool()
+{
+    foreach (DeviceThread *thread, _threads)
+    {
+        thread->quit();
+        thread->wait();
+    }
+    qDeleteAll(_threads);
+    _threads.clear();
+}
+
+QThread *DevicePool::getThread(const QString &uid)
+{
+    DeviceThread *thread = _threads.at(qHash(uid) % _threads.size());
+
+    if (!thread->isRunning())
+        thread->start();
+
+    return thread;
+}
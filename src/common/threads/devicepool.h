@@ -18,48 +18,44 @@
 **
 **************************************************************************************/
 
-#ifndef FOLDERCOMPRESSOR_H
-#define FOLDERCOMPRESSOR_H
+#ifndef DEVICEPOOL_H
+#define DEVICEPOOL_H
 
-#include <QFile>
-#include <QObject>
-#include <QDir>
+#include <QList>
+#include <QString>
+
+#include "devicethread.h"
 
 /**
- * @class FolderCompressor
- *
- * Compress and decompress folders
+ * Fixed set of event loops running the devices
+ * A device always runs on the same thread, chosen from its uid,
+ * so the number of threads does not grow with the number of devices
  */
-class FolderZipper
+class DevicePool
 {
 public:
     /**
-     * A recursive function that scans all files inside the source folder
-     * and serializes all files in a row of file names and compressed
-     * binary data in a single file
+     * Constructor
+     *
+     * @param size Number of threads, one per core if 0
      */
-    static bool compressFolder(QString sourceFolder, QString destinationFile);
-
+    explicit DevicePool(int size = 0);
     /**
-     * A function that deserializes data from the compressed file and
-     * creates any needed subfolders before saving the file
+     * Destructor
+     * Stop the threads, the devices deleted later are deleted on their thread before it ends
      */
-    static bool decompressFolder(QString sourceFile, QString destinationFolder);
-
-private:
-    /// File used
-    static QFile file;
-    /// File stream
-    static QDataStream dataStream;
+    ~DevicePool();
 
     /**
-     * Recursive function that compress folder into a single file
+     * Thread running the device, started on first use
      *
-     * @param sourceFolder Source folder
-     * @param prefex Prefix of the file
-     * @return True if it suceed, false otherwise
+     * @param uid Uid of the device
      */
-    static bool compress(QString sourceFolder, QString prefex = "");
+    QThread *getThread(const QString &uid);
+
+private:
+    /// Threads of the pool
+    QList<DeviceThread *> _threads;
 };
 
-#endif // FOLDERCOMPRESSOR_H
+#endif // DEVICEPOOL_H
@@ -0,0 +1,56 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#include "historycompactionthread.h"
+#include "entities/historystore.h"
+
+#include <QFile>
+#include <QDataStream>
+
+HistoryCompactionThread::HistoryCompactionThread(const QString &fileName, const QList<quint32> &ids,
+                                                 const QList<HistoryElement> &elements) :
+    _fileName(fileName),
+    _ids(ids),
+    _elements(elements),
+    _succeeded(false)
+{
+}
+
+void HistoryCompactionThread::run()
+{
+    QFile file(_fileName);
+
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        QDataStream out(&file);
+
+        // Live elements are written oldest first, as they were appended
+        for (int row = _ids.size() - 1; row >= 0; --row)
+            out << HistoryStore::createAddRecord(_ids.at(row), _elements.at(row));
+
+        _succeeded = (out.status() == QDataStream::Ok && file.flush());
+        file.close();
+    }
+}
+
+bool HistoryCompactionThread::hasSucceeded() const
+{
+    return _succeeded;
+}
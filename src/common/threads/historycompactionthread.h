@@ -0,0 +1,67 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#ifndef HISTORYCOMPACTIONTHREAD_H
+#define HISTORYCOMPACTIONTHREAD_H
+
+#include <QThread>
+#include <QList>
+#include <QString>
+
+#include "entities/historyelement.h"
+
+/**
+ * Writes the compacted history records to a file without blocking the service
+ */
+class HistoryCompactionThread : public QThread
+{
+public:
+    /**
+     * Constructor
+     *
+     * @param fileName File receiving the compacted history
+     * @param ids Record ids of the live elements, same order as elements
+     * @param elements Live elements of the history, most recent first
+     */
+    HistoryCompactionThread(const QString &fileName, const QList<quint32> &ids,
+                            const QList<HistoryElement> &elements);
+    /**
+     * @overload QThread
+     */
+    void run();
+    /**
+     * Defines if the compacted file has been entirely written
+     *
+     * @return True if the file is complete, false otherwise
+     */
+    bool hasSucceeded() const;
+
+private:
+    /// File receiving the compacted history
+    QString _fileName;
+    /// Record ids of the live elements
+    QList<quint32> _ids;
+    /// Live elements of the history, most recent first
+    QList<HistoryElement> _elements;
+    /// True if the file has been entirely written
+    bool _succeeded;
+};
+
+#endif // HISTORYCOMPACTIONTHREAD_H
@@ -0,0 +1,51 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#ifndef LOGTHREAD_H
+#define LOGTHREAD_H
+
+#include <QThread>
+#include <QAtomicInt>
+
+/**
+ * Writes the buffered log lines to the log file
+ */
+class LogThread : public QThread
+{
+public:
+    /**
+     * Default constructor
+     */
+    LogThread();
+    /**
+     * @overload QThread
+     */
+    void run();
+    /**
+     * Ask the thread to write the remaining lines and stop
+     */
+    void stop();
+
+private:
+    /// True once the thread has been asked to stop
+    QAtomicInt _stopped;
+};
+
+#endif // LOGTHREAD_H
@@ -89,19 +89,19 @@ void UdpDiscovery::startMulticastListening(QObject *parent)
     _multicastSocket = new QUdpSocket(parent);
 
     if(!_multicastSocket->bind(QHostAddress::AnyIPv4, UDP_DISCOVERY_MULTICAST_PORT, QUdpSocket::ShareAddress))
-        LogManager::appendLine("[UDP Discovery] Bind problem");
+        ERROR_LOG(LOG_DISCOVERY, "[UDP Discovery] Bind problem");
 
     QNetworkInterface interface = getCurrentNetworkInterface(MULTICAST);
     if(interface.isValid() && _multicastSocket->state() == QAbstractSocket::BoundState)
     {
         _multicastSocket->setMulticastInterface(interface);
-        LogManager::appendLine("[UDP Discovery] Start Multicast listening on interface " + interface.humanReadableName());
+        INFO_LOG(LOG_DISCOVERY, "[UDP Discovery] Start Multicast listening on interface " + interface.humanReadableName());
     }
     else
-        LogManager::appendLine("[UDP Discovery] No interface found or bad state");
+        WARNING_LOG(LOG_DISCOVERY, "[UDP Discovery] No interface found or bad state");
 
     if(!_multicastSocket->joinMulticastGroup(_groupAddress))
-        LogManager::appendLine(" [UDP Discovery] Join problem");
+        ERROR_LOG(LOG_DISCOVERY, " [UDP Discovery] Join problem");
 
     connect(_multicastSocket, SIGNAL(readyRead()),
             this, SLOT(processPendingMulticastDatagrams()));
@@ -109,7 +109,7 @@ void UdpDiscovery::startMulticastListening(QObject *parent)
 
 void UdpDiscovery::startBroadcastListening(QObject *parent)
 {
-    LogManager::appendLine("[UDP Discovery] Start Broadcast listening");
+    INFO_LOG(LOG_DISCOVERY, "[UDP Discovery] Start Broadcast listening");
     _broadcastSocket = new QUdpSocket(parent);
     _broadcastSocket->bind(UDP_DISCOVERY_BROADCAST_PORT);
 
@@ -128,28 +128,28 @@ void UdpDiscovery::sendDatagramBroadcast(QString message)
         {
             if (entry.ip().protocol() == QAbstractSocket::IPv4Protocol)
             {
-                LogManager::appendLine("[UDP Discovery] Interface " +
-                                       entry.broadcast().toString() + " choosen for broadcast (" +
-                                       QString::number(ni.addressEntries().size()) + " interfaces)");
+                DEBUG_LOG(LOG_DISCOVERY, "[UDP Discovery] Interface " +
+                                         entry.broadcast().toString() + " choosen for broadcast (" +
+                                         QString::number(ni.addressEntries().size()) + " interfaces)");
                 address = entry.broadcast();
                 break;
             }
             else
-                LogManager::appendLine("[UDP Discovery] Interface " +
-                                       entry.broadcast().toString() + " dropped (" +
-                                       QString::number(ni.addressEntries().size()) + " interfaces)");
+                DEBUG_LOG(LOG_DISCOVERY, "[UDP Discovery] Interface " +
+                                         entry.broadcast().toString() + " dropped (" +
+                                         QString::number(ni.addressEntries().size()) + " interfaces)");
         }
     } else {
-        LogManager::appendLine("[UDP Discovery] No interface found");
+        WARNING_LOG(LOG_DISCOVERY, "[UDP Discovery] No interface found");
     }
 
-    LogManager::appendLine("[UDP Discovery] Broadcast send " + message + " to ip " + address.toString());
+    DEBUG_LOG(LOG_DISCOVERY, "[UDP Discovery] Broadcast send " + message + " to ip " + address.toString());
     _broadcastSocket->writeDatagram(message.toUtf8(), address, UDP_DISCOVERY_BROADCAST_PORT);
 }
 
 void UdpDiscovery::sendDatagramMulticast(QString message)
 {
-    LogManager::appendLine("[UDP Discovery] Multicast send " + message);
+    DEBUG_LOG(LOG_DISCOVERY, "[UDP Discovery] Multicast send " + message);
     _multicastSocket->writeDatagram(message.toUtf8(), _groupAddress, UDP_DISCOVERY_MULTICAST_PORT);
 }
 
@@ -215,20 +215,17 @@ void UdpDiscovery::processPendingDatagrams(QUdpSocket *socket, SocketType type)
         QHostInfo info;
         QList<QHostAddress> list;
         QString message;
-        QString logMessage;
 
         datagram.resize(socket->pendingDatagramSize());
         socket->readDatagram(datagram.data(), datagram.size(), &hostAdress);
+        MetricsManager::increment(METRIC_DISCOVERY_DATAGRAMS);
 
         if(!isLocalAdress(hostAdress))
         {
             message = QString::fromUtf8(datagram);
 
-            if (type == BROADCAST)
-                logMessage = "[UDP Discovery] Received datagram from broadcast : ";
-            else
-                logMessage = "[UDP Discovery] Received datagram from multicast : ";
-            LogManager::appendLine(logMessage + message);
+            DEBUG_LOG(LOG_DISCOVERY, QString("[UDP Discovery] Received datagram from ")
+                                     + (type == BROADCAST ? "broadcast : " : "multicast : ") + message);
 
             if(message.startsWith(PREFIX))
             {
@@ -245,13 +242,14 @@ void UdpDiscovery::processPendingDatagrams(QUdpSocket *socket, SocketType type)
                     {
                         if(message.endsWith(ACTION_RECORD))
                         {
+                            DeviceRecord record;
+
                             list.append(hostAdress);
                             info.setAddresses(list);
-                            Device *device = parse(message, info);
-                            if (device)
+                            if (parse(message, info, record))
                             {
-                                device->setDetectedBy(DETECTED_BY_UDP);
-                                _list.push_back(device);
+                                record._detectedBy = DETECTED_BY_UDP;
+                                _list.push_back(record);
                             }
                         }
                         else
@@ -265,7 +263,7 @@ void UdpDiscovery::processPendingDatagrams(QUdpSocket *socket, SocketType type)
                                 else
                                 {
                                     if(message.endsWith(ACTION_LEAVE))
-                                        LogManager::appendLine(QString("[UDP Discovery] Device Leave"));
+                                        DEBUG_LOG(LOG_DISCOVERY, QString("[UDP Discovery] Device Leave"));
                                 }
                             }
                         }
@@ -276,35 +274,34 @@ void UdpDiscovery::processPendingDatagrams(QUdpSocket *socket, SocketType type)
     }
 }
 
-Device* UdpDiscovery::parse(QString message, QHostInfo &info)
+bool UdpDiscovery::parse(QString message, QHostInfo &info, DeviceRecord &record)
 {
-    Device *device = 0;
     QStringList lst = message.split(';');
-    QString name, uid, type, version;
-    int port;
 
-    name = lst.at(0);
-    name.remove(PREFIX);
+    record._name = lst.at(0);
+    record._name.remove(PREFIX);
+    record._hostInfo = info;
 
     if (lst.size() > 1)
     {
-        type = lst.at(1);
+        record._type = lst.at(1);
         if (lst.size() > 2)
-            uid = lst.at(2);
+            record._uid = lst.at(2);
         if (lst.size() > 3)
-            version = lst.at(3);
+            record._version = lst.at(3);
         if (lst.size() > 4)
-            port = lst.at(4).toInt();
+            record._port = lst.at(4).toInt();
+        // Older records end with the action, which is not a number
+        if (lst.size() > 5)
+            record._features = lst.at(5).toUInt();
     }
-    if (uid != SettingsManager::getDeviceUID())
-        device = new Device(name, type, uid, info, port, version);
 
-    return device;
+    return (record._uid != SettingsManager::getDeviceUID());
 }
 
 void UdpDiscovery::sendDatagram(QString message, QHostAddress address)
 {
-    LogManager::appendLine("[UDP Discovery] Send " + message + " to " + address.toString());
+    DEBUG_LOG(LOG_DISCOVERY, "[UDP Discovery] Send " + message + " to " + address.toString());
     _multicastSocket->writeDatagram(message.toUtf8(), address, UDP_DISCOVERY_MULTICAST_PORT);
 }
 
@@ -330,11 +327,13 @@ void UdpDiscovery::sendRecord(QHostAddress address)
             .append(QString(PROTOCOL_VERSION))
             .append(';')
             .append(QString::number(_port))
+            .append(';')
+            .append(QString::number(PROTOCOL_FEATURES))
             .append(';').append(ACTION_RECORD);
 
     sendDatagram(message, address);
 
-    LogManager::appendLine("[UDP Discovery] Send record " + message);
+    DEBUG_LOG(LOG_DISCOVERY, "[UDP Discovery] Send record " + message);
 }
 
 void UdpDiscovery::leave()
@@ -29,7 +29,9 @@
 #include <QNetworkInterface>
 
 #include "helpers/logmanager.h"
+#include "helpers/metricsmanager.h"
 #include "entities/device.h"
+#include "entities/devicerecord.h"
 #include "config/appconfig.h"
 #include "helpers/settingsmanager.h"
 
@@ -111,13 +113,14 @@ private:
      */
     void sendDatagramMulticast(QString message);
     /**
-     * Parse a device string to retrieve a device
+     * Parse a device string to retrieve a device record
      *
      * @param message Message to send
      * @param info Informations about the device
-     * @return The corresponding allocated device
+     * @param record Record filled with the device informations
+     * @return False if the message is our own record, true otherwise
      */
-    Device *parse(QString message, QHostInfo &info);
+    bool parse(QString message, QHostInfo &info, DeviceRecord &record);
 
     /// Multicast socket
     QUdpSocket *_multicastSocket;
@@ -126,7 +129,7 @@ private:
     /// Address of the multicast group
     QHostAddress _groupAddress;
     /// List of detected devices
-    QList<Device *> _list;
+    QList<DeviceRecord> _list;
     /// Timer for device detection
     QTimer _timer;
     /// Udp port for device detection
@@ -187,7 +190,7 @@ signals:
      *
      * @param lst List of found devices
      */
-    void devicesFound(const QList<Device *> &lst);
+    void devicesFound(const QList<DeviceRecord> &lst);
     /**
      * New device found
      *
@@ -23,12 +23,11 @@
 #include "appconfig.h"
 #include "filehelper.h"
 #include "settingsmanager.h"
-#include "historyelementview.h"
+#include "historylistwidget.h"
 
 #include <QFile>
 #include <QDebug>
 #include <QDir>
-#include <QListWidget>
 
 ConfigPanel::ConfigPanel(QWidget *parent) :
     QWidget(parent),
@@ -119,12 +118,7 @@ void ConfigPanel::updateRefreshFrame(int frame)
 
 void ConfigPanel::clearHistory()
 {
-    QListWidgetItem *item;
-    while (ui->historyListWidget->count() != 0)
-    {
-        item = ui->historyListWidget->takeItem(0);
-        delete item;
-    }
+    ui->historyListWidget->clearHistory();
 }
 
 void ConfigPanel::refreshEnded()
@@ -0,0 +1,193 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#include "historydelegate.h"
+#include "historymodel.h"
+#include "helpers/filehelper.h"
+#include "appconfig.h"
+
+#include <QAbstractItemView>
+#include <QApplication>
+#include <QMouseEvent>
+#include <QPainter>
+
+/// Horizontal and vertical margin inside a row
+#define ROW_MARGIN 5
+/// Width of the column showing the icon, the date and the user name
+#define LEFT_COLUMN_WIDTH 70
+/// Height of the download progress bar
+#define PROGRESS_BAR_HEIGHT 8
+/// Size of the cancel button of a download
+#define CANCEL_BUTTON_SIZE 17
+/// Maximum number of characters displayed for a text or an URL
+#define MAX_TEXT_SIZE 100
+
+HistoryDelegate::HistoryDelegate(QObject *parent) :
+    QStyledItemDelegate(parent),
+    _smallFont("Roboto"),
+    _textFont("Roboto")
+{
+    _smallFont.setPixelSize(9);
+    _textFont.setPixelSize(10);
+}
+
+void HistoryDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    QStyleOptionViewItem background(option);
+    const QWidget *widget = option.widget;
+    QStyle *style = widget ? widget->style() : QApplication::style();
+
+    // Hover and separator from the style sheet, the content is drawn below
+    initStyleOption(&background, index);
+    background.text.clear();
+    background.icon = QIcon();
+    background.features &= ~(QStyleOptionViewItem::HasDisplay | QStyleOptionViewItem::HasDecoration);
+    style->drawControl(QStyle::CE_ItemViewItem, &background, painter, widget);
+
+    const QRect &rect = option.rect;
+    QFontMetrics smallMetrics(_smallFont);
+    QFontMetrics textMetrics(_textFont);
+    QRect leftColumn(rect.left() + ROW_MARGIN, rect.top(), LEFT_COLUMN_WIDTH, HISTORY_ROW_HEIGHT);
+    QRect iconRect(leftColumn.center().x() - HISTORY_ICON_SIZE / 2, leftColumn.top() + ROW_MARGIN,
+                   HISTORY_ICON_SIZE, HISTORY_ICON_SIZE);
+    QRect dateRect(leftColumn.left(), iconRect.bottom() + 2, leftColumn.width(), smallMetrics.height());
+    QRect userRect(leftColumn.left(), dateRect.bottom() + 1, leftColumn.width(), smallMetrics.height());
+    QString userName = smallMetrics.elidedText(index.data(HistoryModel::UserNameRole).toString(),
+                                               Qt::ElideRight, userRect.width());
+
+    painter->save();
+
+    qvariant_cast<QIcon>(index.data(Qt::DecorationRole)).paint(painter, iconRect);
+
+    painter->setFont(_smallFont);
+    painter->setPen(QColor("#444444"));
+    painter->drawText(dateRect, Qt::AlignCenter, index.data(HistoryModel::DateRole).toString());
+    painter->setPen(QColor("#3E9BD5"));
+    painter->drawText(userRect, Qt::AlignCenter, userName);
+
+    if (isFileFolder(index))
+    {
+        int left = leftColumn.right() + 2 * ROW_MARGIN;
+        int width = rect.right() - ROW_MARGIN - left;
+        QRect nameRect(left, rect.top() + 2 * ROW_MARGIN, width, textMetrics.height());
+        QRect sizeRect(left, nameRect.bottom() + ROW_MARGIN, width, smallMetrics.height());
+        int progress = index.data(HistoryModel::ProgressRole).toInt();
+
+        painter->setPen(QColor("#444444"));
+        painter->drawText(sizeRect, Qt::AlignRight | Qt::AlignVCenter,
+                          FileHelper::getSizeAsString(index.data(HistoryModel::SizeRole).toLongLong()));
+        painter->setFont(_textFont);
+        painter->drawText(nameRect, Qt::AlignLeft | Qt::AlignVCenter,
+                          textMetrics.elidedText(displayedText(index), Qt::ElideRight, width));
+
+        if (progress >= 0)
+        {
+            QRect cancelRect = cancelButtonRect(rect);
+            QRect barRect(rect.left() + ROW_MARGIN, cancelRect.center().y() - PROGRESS_BAR_HEIGHT / 2,
+                          cancelRect.left() - rect.left() - 2 * ROW_MARGIN, PROGRESS_BAR_HEIGHT);
+            QRect chunkRect(barRect);
+
+            chunkRect.setWidth(barRect.width() * progress / 100);
+            painter->fillRect(barRect, Qt::white);
+            painter->fillRect(chunkRect, QColor("#7CB2D3"));
+            painter->drawPixmap(cancelRect, QPixmap((option.state & QStyle::State_MouseOver) ?
+                                                        HISTORY_CANCEL_HOVER_ICON : HISTORY_CANCEL_ICON));
+        }
+    }
+    else
+    {
+        painter->setFont(_textFont);
+        painter->setPen(QColor("#444444"));
+        painter->drawText(textRect(rect), Qt::AlignLeft | Qt::AlignVCenter | Qt::TextWrapAnywhere,
+                          displayedText(index));
+    }
+
+    painter->restore();
+}
+
+QSize HistoryDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    if (isFileFolder(index))
+    {
+        bool downloading = index.data(HistoryModel::ProgressRole).toInt() >= 0;
+
+        return QSize(0, HISTORY_ROW_HEIGHT + (downloading ? HISTORY_PROGRESS_HEIGHT : 0));
+    }
+
+    const QAbstractItemView *view = qobject_cast<const QAbstractItemView *>(option.widget);
+    int rowWidth = view ? view->viewport()->width() : option.rect.width();
+    QRect bounds = textRect(QRect(0, 0, rowWidth, HISTORY_ROW_HEIGHT));
+    QFontMetrics textMetrics(_textFont);
+
+    bounds = textMetrics.boundingRect(QRect(0, 0, bounds.width(), 0),
+                                      Qt::AlignLeft | Qt::TextWrapAnywhere, displayedText(index));
+
+    return QSize(0, qMax(HISTORY_ROW_HEIGHT, bounds.height() + 4 * ROW_MARGIN));
+}
+
+bool HistoryDelegate::editorEvent(QEvent *event, QAbstractItemModel *model,
+                                  const QStyleOptionViewItem &option, const QModelIndex &index)
+{
+    if (event->type() == QEvent::MouseButtonRelease
+            && index.data(HistoryModel::ProgressRole).toInt() >= 0)
+    {
+        QMouseEvent *mouseEvent = static_cast<QMouseEvent *>(event);
+
+        if (cancelButtonRect(option.rect).contains(mouseEvent->pos()))
+        {
+            emit cancelIncomingTransfert(index.row());
+            return true;
+        }
+    }
+
+    return QStyledItemDelegate::editorEvent(event, model, option, index);
+}
+
+QRect HistoryDelegate::textRect(const QRect &rect) const
+{
+    int left = rect.left() + LEFT_COLUMN_WIDTH + 3 * ROW_MARGIN;
+
+    return QRect(left, rect.top() + 2 * ROW_MARGIN,
+                 rect.right() - ROW_MARGIN - left, rect.height() - 4 * ROW_MARGIN);
+}
+
+QRect HistoryDelegate::cancelButtonRect(const QRect &rect) const
+{
+    return QRect(rect.right() - ROW_MARGIN - CANCEL_BUTTON_SIZE,
+                 rect.top() + HISTORY_ROW_HEIGHT + (HISTORY_PROGRESS_HEIGHT - CANCEL_BUTTON_SIZE) / 2,
+                 CANCEL_BUTTON_SIZE, CANCEL_BUTTON_SIZE);
+}
+
+QString HistoryDelegate::displayedText(const QModelIndex &index) const
+{
+    QString text = index.data(HistoryModel::TextRole).toString();
+
+    if (!isFileFolder(index) && text.size() > MAX_TEXT_SIZE)
+        text = text.left(MAX_TEXT_SIZE).append(" ...");
+
+    return text;
+}
+
+bool HistoryDelegate::isFileFolder(const QModelIndex &index) const
+{
+    int type = index.data(HistoryModel::TypeRole).toInt();
+
+    return (type == HISTORY_FOLDER_TYPE || type == HISTORY_FILE_TYPE);
+}
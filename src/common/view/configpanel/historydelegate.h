@@ -0,0 +1,95 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#ifndef HISTORYDELEGATE_H
+#define HISTORYDELEGATE_H
+
+#include <QStyledItemDelegate>
+#include <QFont>
+
+/**
+ * @class HistoryDelegate
+ *
+ * Paints the rows of the history view from the HistoryModel data, so no
+ * widget is created per history element.
+ */
+class HistoryDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    /// Constructor
+    explicit HistoryDelegate(QObject *parent = 0);
+
+    /// See QStyledItemDelegate::paint()
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const;
+    /// See QStyledItemDelegate::sizeHint()
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const;
+
+signals:
+    /**
+     * Notify that a transfert is canceled
+     *
+     * @param row Row of the canceled transfert
+     */
+    void cancelIncomingTransfert(int row);
+
+protected:
+    /// See QStyledItemDelegate::editorEvent()
+    bool editorEvent(QEvent *event, QAbstractItemModel *model,
+                     const QStyleOptionViewItem &option, const QModelIndex &index);
+
+private:
+    /// Font of the dates, sizes and user names
+    QFont _smallFont;
+    /// Font of the file names and texts
+    QFont _textFont;
+
+    /**
+     * Get the area of the text of a text or URL element
+     *
+     * @param rect Area of the row
+     * @return The area of the text
+     */
+    QRect textRect(const QRect &rect) const;
+    /**
+     * Get the area of the cancel button of an element being downloaded
+     *
+     * @param rect Area of the row
+     * @return The area of the button
+     */
+    QRect cancelButtonRect(const QRect &rect) const;
+    /**
+     * Get the text to display for an element
+     *
+     * @param index Index of the element
+     * @return The text, truncated for texts and URLs
+     */
+    QString displayedText(const QModelIndex &index) const;
+    /**
+     * Defines if the element is a file or a folder
+     *
+     * @param index Index of the element
+     * @return True if the element is a file or a folder, false otherwise
+     */
+    bool isFileFolder(const QModelIndex &index) const;
+};
+
+#endif // HISTORYDELEGATE_H
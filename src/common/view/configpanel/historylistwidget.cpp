@@ -29,19 +29,29 @@
 
 HistoryListWidget::HistoryListWidget(QWidget *parent) :
     _view(0),
-    QListWidget(parent)
+    QListView(parent)
 {
     // Stylesheet
     setStyleSheet(FileHelper::loadFileContent(HISTORY_LIST_CSS));
     setAttribute(Qt::WA_MacShowFocusRect, false);
 
+    // Rows are painted by the delegate and relaid out with the view width
+    _model = new HistoryModel(this);
+    _delegate = new HistoryDelegate(this);
+    setModel(_model);
+    setItemDelegate(_delegate);
+    setResizeMode(QListView::Adjust);
+    setMouseTracking(true);
+    connect(_delegate, SIGNAL(cancelIncomingTransfert(int)),
+            this, SLOT(onCancelIncomingTransfert(int)));
+
     // Elements context menu
     createContextMenuActions();
     setContextMenuPolicy(Qt::CustomContextMenu);
     connect(this, SIGNAL(customContextMenuRequested(const QPoint&)),
             this, SLOT(onContextMenuRequested(const QPoint&)));
-    connect(this, SIGNAL(itemDoubleClicked(QListWidgetItem*)),
-            this, SLOT(onItemDoubleClicked(QListWidgetItem *)));
+    connect(this, SIGNAL(doubleClicked(const QModelIndex&)),
+            this, SLOT(onItemDoubleClicked(const QModelIndex&)));
 }
 
 HistoryListWidget::~HistoryListWidget()
@@ -59,7 +69,7 @@ HistoryListWidget::~HistoryListWidget()
 
 QSize HistoryListWidget::contentSize() const
 {
-    return QListWidget::contentsSize();
+    return QListView::contentsSize();
 }
 
 void HistoryListWidget::createContextMenuActions()
@@ -103,34 +113,35 @@ void HistoryListWidget::onHistoryOpenActionTriggered()
 
 void HistoryListWidget::onDeleteFromHistoryTriggered()
 {
-    int correspondingRow = row(_rightClickHistoryElement);
-    QListWidgetItem *item = takeItem(correspondingRow);
+    int correspondingRow = _rightClickHistoryElement.row();
 
-    delete item;
+    if (correspondingRow >= 0)
+    {
+        _model->removeElement(correspondingRow);
 
-    emit deleteFromHistory(correspondingRow);
+        emit deleteFromHistory(correspondingRow);
+    }
 }
 
 void HistoryListWidget::onDeleteFromDiskTriggered()
 {
-    HistoryElementView *element = qobject_cast<HistoryElementView *>(itemWidget(_rightClickHistoryElement));
-
-    FileHelper::deleteFileFromDisk(element->getText());
-    onDeleteFromHistoryTriggered();
+    if (_rightClickHistoryElement.isValid())
+    {
+        FileHelper::deleteFileFromDisk(_rightClickHistoryElement.data(HistoryModel::TextRole).toString());
+        onDeleteFromHistoryTriggered();
+    }
 }
 
 void HistoryListWidget::onClearHistoryTriggered()
 {
     emit clearHistoryTriggered();
     clearHistory();
-    _history.clear();
 }
 
 void HistoryListWidget::onClipboardActionTriggered()
 {
-    HistoryElementView *elementView = qobject_cast<HistoryElementView *>(itemWidget(_rightClickHistoryElement));
-
-    FileHelper::saveToClipboard(elementView->getText());
+    if (_rightClickHistoryElement.isValid())
+        FileHelper::saveToClipboard(_rightClickHistoryElement.data(HistoryModel::TextRole).toString());
 }
 
 void HistoryListWidget::onOpenDownloadFolderTriggered()
@@ -141,67 +152,62 @@ void HistoryListWidget::onOpenDownloadFolderTriggered()
     FileHelper::openURL("file:///" + QDir::toNativeSeparators(SettingsManager::getDestinationFolder()));
 }
 
-void HistoryListWidget::openActionHistoryItem(QListWidgetItem *item)
+void HistoryListWidget::openActionHistoryItem(const QModelIndex &index)
 {
     QFileInfo fileInfo;
-    HistoryElementView *elementView = qobject_cast<HistoryElementView *>(itemWidget(item));
+    QString text = index.data(HistoryModel::TextRole).toString();
 
-    switch (elementView->getType())
+    if (!index.isValid())
+        return;
+
+    switch (index.data(HistoryModel::TypeRole).toInt())
     {
     case HISTORY_FOLDER_TYPE:
     case HISTORY_FILE_TYPE:
-        fileInfo = QFileInfo(SettingsManager::getDestinationFolder() + "/" + elementView->getText());
+        fileInfo = QFileInfo(SettingsManager::getDestinationFolder() + "/" + text);
 
         if (fileInfo.exists())
             FileHelper::openURL("file:///" + fileInfo.absoluteFilePath());
         break;
     case HISTORY_URL_TYPE:
-        FileHelper::openURL(elementView->getText());
+        FileHelper::openURL(text);
         break;
     }
 }
 
 void HistoryListWidget::clearHistory()
 {
-    QListWidgetItem *item;
-
-    while (count() != 0)
-    {
-        item = takeItem(0);
-
-        delete item;
-    }
-    QListWidget::resizeContents(contentSize().width(), -1);
+    _model->clear();
 }
 
 void HistoryListWidget::onContextMenuRequested(const QPoint &pos)
 {
-    QListWidgetItem *item = itemAt(pos);
+    QModelIndex index = indexAt(pos);
 
-    if (item)
+    if (index.isValid())
     {
-        HistoryElementView *historyElement = qobject_cast<HistoryElementView *>(itemWidget(item));
-        _rightClickHistoryElement = item;
+        _rightClickHistoryElement = index;
 
-        switch (historyElement->getType())
+        switch (index.data(HistoryModel::TypeRole).toInt())
         {
         case HISTORY_FOLDER_TYPE:
         case HISTORY_FILE_TYPE:
-            manageFileHistoryContextMenu(historyElement);
+            manageFileHistoryContextMenu(index);
             break;
         default:
-            manageTextUrlHistoryContextMenu(historyElement);
+            manageTextUrlHistoryContextMenu(index);
             break;
         }
 
-        _contextMenu.exec(mapToGlobal(pos));
+        _contextMenu.exec(viewport()->mapToGlobal(pos));
     }
 }
 
-void HistoryListWidget::manageFileHistoryContextMenu(HistoryElementView *historyElement)
+void HistoryListWidget::manageFileHistoryContextMenu(const QModelIndex &index)
 {
-    QString info = historyElement->getText();
+    QString info = index.data(HistoryModel::TextRole).toString();
     QFileInfo file(SettingsManager::getDestinationFolder() + "/" + info);
+    bool downloading = index.data(HistoryModel::ProgressRole).toInt() >= 0;
     bool enabled;
 
     _historyOpenDownloadFolder->setVisible(true);
@@ -219,19 +225,22 @@ void HistoryListWidget::manageFileHistoryContextMenu(HistoryElementView *history
         _historyOpenAction->setIcon(QIcon(HISTORY_LAUNCH_ICON));
         _historyOpenAction->setText(tr("Ouvrir le fichier"));
     }
-    info.append(" (").append(historyElement->getFileSize()).append(")");
-    _historyInfo->setIcon(historyElement->getIcon());
+    info.append(" (")
+            .append(FileHelper::getSizeAsString(index.data(HistoryModel::SizeRole).toLongLong()))
+            .append(")");
+    _historyInfo->setIcon(qvariant_cast<QIcon>(index.data(Qt::DecorationRole)));
     _historyInfo->setText(info);
-    _deleteFromHistory->setEnabled(!historyElement->isDownloading());
+    _deleteFromHistory->setEnabled(!downloading);
 
-    enabled = (historyElement->isDownloading()
-               || !FileHelper::exists(historyElement->getText()));
+    enabled = (downloading
+               || !FileHelper::exists(index.data(HistoryModel::TextRole).toString()));
     _historyOpenAction->setEnabled(!enabled);
     _deleteFromDisk->setEnabled(!enabled);
 }
 
-void HistoryListWidget::manageTextUrlHistoryContextMenu(HistoryElementView *historyElement)
+void HistoryListWidget::manageTextUrlHistoryContextMenu(const QModelIndex &index)
 {
+    QString text = index.data(HistoryModel::TextRole).toString();
     QString historyInfoString;
     int maxCharDisplayed = 50;
 
@@ -242,7 +251,7 @@ void HistoryListWidget::manageTextUrlHistoryContextMenu(HistoryElementView *hist
 
     _deleteFromHistory->setEnabled(true);
 
-    if (historyElement->getType() == HISTORY_URL_TYPE)
+    if (index.data(HistoryModel::TypeRole).toInt() == HISTORY_URL_TYPE)
     {
         _historyInfo->setIcon(QIcon(URL_ICON));
         _historyOpenAction->setVisible(true);
@@ -254,57 +263,53 @@ void HistoryListWidget::manageTextUrlHistoryContextMenu(HistoryElementView *hist
         _historyOpenAction->setVisible(false);
     }
 
-    historyInfoString = historyElement->getText().left(maxCharDisplayed);
-    if (historyElement->getText().size() > maxCharDisplayed)
+    historyInfoString = text.left(maxCharDisplayed);
+    if (text.size() > maxCharDisplayed)
         historyInfoString.append(" ...");
 
     _historyInfo->setText(historyInfoString);
 }
 
-void HistoryListWidget::onItemDoubleClicked(QListWidgetItem *item)
+void HistoryListWidget::onItemDoubleClicked(const QModelIndex &index)
 {
-    openActionHistoryItem(item);
+    openActionHistoryItem(index);
 }
 
-void HistoryListWidget::historyElementProgressUpdated(unsigned progress)
+void HistoryListWidget::historyElementProgressUpdated(const HistoryElement &element, unsigned progress)
 {
-    if (count() > 0)
-    {
-        QListWidgetItem *firstItem = item(0);
-        HistoryElementView *elt = qobject_cast<HistoryElementView *>(itemWidget(firstItem));
-
-        if (elt->getType() == HISTORY_FOLDER_TYPE || elt->getType() == HISTORY_FILE_TYPE)
-        {
-            if (progress == 100) {
-                onHistoryChanged(_history);
-            }
-            else {
-                elt->setProgress(progress);
-                firstItem->setSizeHint(QSize(0, elt->sizeHint().height() + 5));
-            }
-        }
-    }
+    // The row grows or shrinks when its progress bar is shown or hidden
+    if (_model->setProgress(element, progress))
+        scheduleDelayedItemsLayout();
 }
 
 void HistoryListWidget::onHistoryChanged(const QList<HistoryElement> &history)
 {
-    clearHistory();
-    _history = history;
-    foreach(HistoryElement elt, history)
-    {
-        HistoryElementView *historyViewElement = new HistoryElementView(elt.getDateTime("dd/MM - hh:mm"), elt.getText(), elt.getName(), elt.getSize(), elt.getType());
-        QListWidgetItem *item = new QListWidgetItem();
+    _model->setHistory(history);
+}
 
-        connect(historyViewElement, SIGNAL(cancelIncomingTransfert()),
-                _view, SLOT(onCancelIncomingTransfert()));
+void HistoryListWidget::onHistoryElementAdded(const HistoryElement &element)
+{
+    _model->addElement(element);
+}
 
-        item->setSizeHint(QSize(0,historyViewElement->sizeHint().height() + 10));
-        addItem(item);
-        setItemWidget(item, historyViewElement);
-    }
+void HistoryListWidget::onHistoryElementRemoved(int row)
+{
+    _model->removeElement(row);
 }
 
 void HistoryListWidget::setView(View *view)
 {
+    if (_view)
+        disconnect(this, SIGNAL(cancelIncomingTransfert(const HistoryElement&)),
+                   _view, SLOT(onCancelIncomingTransfert(const HistoryElement&)));
+
     _view = view;
+    connect(this, SIGNAL(cancelIncomingTransfert(const HistoryElement&)),
+            _view, SLOT(onCancelIncomingTransfert(const HistoryElement&)));
+}
+
+void HistoryListWidget::onCancelIncomingTransfert(int row)
+{
+    if (row >= 0 && row < _model->rowCount())
+        emit cancelIncomingTransfert(_model->getElement(row));
 }
@@ -21,19 +21,21 @@
 #ifndef HISTORYLISTWIDGET_H
 #define HISTORYLISTWIDGET_H
 
-#include <QListWidget>
+#include <QListView>
 #include <QAction>
 #include <QMenu>
 
 #include "view.h"
-#include "historyelementview.h"
+#include "historymodel.h"
+#include "historydelegate.h"
 
 /**
  * @class Advanced history list widget
  *
- * This class shows the history
+ * This class shows the history. Rows are painted on demand by the
+ * HistoryDelegate from the HistoryModel.
  */
-class HistoryListWidget : public QListWidget
+class HistoryListWidget : public QListView
 {
     Q_OBJECT
 public:
@@ -48,9 +50,9 @@ public:
     /**
      * Try to open a file or a link from an history item
      *
-     * @param item History Item
+     * @param index Index of the history item
      */
-    void openActionHistoryItem(QListWidgetItem *item);
+    void openActionHistoryItem(const QModelIndex &index);
     /**
      * Clear the history
      */
@@ -71,6 +73,12 @@ signals:
      * Notify the service for an history clean up
      */
     void clearHistoryTriggered();
+    /**
+     * Notify the view for an incoming transfert canceled
+     *
+     * @param element History element of the transfert
+     */
+    void cancelIncomingTransfert(const HistoryElement &element);
 
 
 private slots:
@@ -105,30 +113,47 @@ private slots:
     /**
       * On history item double clicked
       */
-    void onItemDoubleClicked(QListWidgetItem *item);
+    void onItemDoubleClicked(const QModelIndex &index);
+    /**
+      * On cancel button of a downloading row clicked
+      */
+    void onCancelIncomingTransfert(int row);
 
 public slots:
     /**
-     * SLOT : Download (on last history element) progress changed
+     * SLOT : Download progress of an history element changed
      *
+     * @param element History element being downloaded
      * @param progress Download progress percentage
      */
-    void historyElementProgressUpdated(unsigned progress);
+    void historyElementProgressUpdated(const HistoryElement &element, unsigned progress);
     /**
      * SLOT : on history changed
      * @param history New history value
      */
     void onHistoryChanged(const QList<HistoryElement> &history);
+    /**
+     * SLOT : on history element added
+     * @param element New history element
+     */
+    void onHistoryElementAdded(const HistoryElement &element);
+    /**
+     * SLOT : on history element removed
+     * @param row Row of the removed element
+     */
+    void onHistoryElementRemoved(int row);
 
 private:
-    /// List of displayed elements
-    QList<HistoryElement> _history;
+    /// Model of the displayed elements
+    HistoryModel *_model;
+    /// Painter of the history rows
+    HistoryDelegate *_delegate;
     /// Main View
     View *_view;
     /// Context menu of the history view
     QMenu _contextMenu;
     /// History element correponding to the right click on the history view
-    QListWidgetItem *_rightClickHistoryElement;
+    QPersistentModelIndex _rightClickHistoryElement;
     /// Open the corresponding history view element
     QAction *_historyOpenAction;
     /// Open the current download folder
@@ -151,15 +176,15 @@ private:
     /**
      * Manage the right click on an history element containing a file or a folder
      *
-     * @param historyElement Aimed element
+     * @param index Index of the aimed element
      */
-    void manageFileHistoryContextMenu(HistoryElementView *historyElement);
+    void manageFileHistoryContextMenu(const QModelIndex &index);
     /**
      * Manage the right click on an history element containing text or URL
      *
-     * @param historyElement Aimed element
+     * @param index Index of the aimed element
      */
-    void manageTextUrlHistoryContextMenu(HistoryElementView *historyElement);
+    void manageTextUrlHistoryContextMenu(const QModelIndex &index);
 };
 
 #endif // HISTORYLISTWIDGET_H
@@ -0,0 +1,177 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#include "historymodel.h"
+#include "helpers/filehelper.h"
+#include "appconfig.h"
+
+/// Progress value of a row which is not downloading
+#define NO_PROGRESS -1
+
+HistoryModel::HistoryModel(QObject *parent) :
+    QAbstractListModel(parent)
+{
+}
+
+int HistoryModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : _history.size();
+}
+
+QVariant HistoryModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= _history.size())
+        return QVariant();
+
+    HistoryElement element = _history.at(index.row());
+
+    switch (role)
+    {
+    case Qt::DisplayRole:
+    case TextRole:
+        return element.getText();
+    case Qt::ToolTipRole:
+        return element.getText().left(100);
+    case TypeRole:
+        return element.getType();
+    case DateRole:
+        return element.getDateTime("dd/MM - hh:mm");
+    case UserNameRole:
+        return element.getName();
+    case SizeRole:
+        return element.getSize();
+    case ProgressRole:
+        return _progress.at(index.row());
+    case Qt::DecorationRole:
+        switch (element.getType())
+        {
+        case HISTORY_FILE_TYPE:
+            return getFileIcon(element.getText());
+        case HISTORY_FOLDER_TYPE:
+            return QIcon(FOLDER_ICON);
+        case HISTORY_URL_TYPE:
+            return QIcon(URL_ICON);
+        default:
+            return QIcon(TEXT_ICON);
+        }
+    }
+
+    return QVariant();
+}
+
+void HistoryModel::setHistory(const QList<HistoryElement> &history)
+{
+    beginResetModel();
+    _history = history;
+    _progress.clear();
+    for (int i = 0; i < _history.size(); ++i)
+        _progress.append(NO_PROGRESS);
+    endResetModel();
+}
+
+void HistoryModel::addElement(const HistoryElement &element)
+{
+    insertElement(0, element);
+}
+
+void HistoryModel::removeElement(int row)
+{
+    if (row >= 0 && row < _history.size())
+        removeElements(row, row);
+}
+
+void HistoryModel::clear()
+{
+    if (!_history.isEmpty())
+        removeElements(0, _history.size() - 1);
+}
+
+HistoryElement HistoryModel::getElement(int row) const
+{
+    return _history.at(row);
+}
+
+bool HistoryModel::setProgress(const HistoryElement &element, unsigned progress)
+{
+    int row = _history.indexOf(element);
+
+    if (row == -1)
+        return false;
+
+    HistoryElementType type = _history.at(row).getType();
+
+    if (type != HISTORY_FILE_TYPE && type != HISTORY_FOLDER_TYPE)
+        return false;
+
+    int value = (progress >= 100) ? NO_PROGRESS : progress;
+    int previous = _progress.at(row);
+
+    if (previous == value)
+        return false;
+
+    _progress[row] = value;
+    emit dataChanged(index(row), index(row));
+
+    return (previous == NO_PROGRESS) != (value == NO_PROGRESS);
+}
+
+QIcon HistoryModel::getFileIcon(const QString &fileName)
+{
+    QIcon icon;
+
+    if (FileHelper::isSpreadsheet(fileName)) {
+        icon = QIcon(XLSX_ICON);
+    } else if(FileHelper::isDoc(fileName)) {
+        icon = QIcon(DOC_ICON);
+    } else if(FileHelper::isPdf(fileName)) {
+        icon = QIcon(PDF_ICON);
+    } else if(FileHelper::isZip(fileName)) {
+        icon = QIcon(ZIP_ICON);
+    } else if(FileHelper::isMusic(fileName)) {
+        icon = QIcon(MUSIC_ICON);
+    } else if(FileHelper::isImage(fileName)) {
+        icon = QIcon(IMG_ICON);
+    } else if(FileHelper::isMovie(fileName)) {
+        icon = QIcon(MOVIE_ICON);
+    } else {
+        icon = QIcon(FILE_ICON);
+    }
+
+    return icon;
+}
+
+void HistoryModel::insertElement(int row, const HistoryElement &element)
+{
+    beginInsertRows(QModelIndex(), row, row);
+    _history.insert(row, element);
+    _progress.insert(row, NO_PROGRESS);
+    endInsertRows();
+}
+
+void HistoryModel::removeElements(int first, int last)
+{
+    beginRemoveRows(QModelIndex(), first, last);
+    for (int i = last; i >= first; --i)
+    {
+        _history.removeAt(i);
+        _progress.removeAt(i);
+    }
+    endRemoveRows();
+}
@@ -0,0 +1,128 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#ifndef HISTORYMODEL_H
+#define HISTORYMODEL_H
+
+#include <QAbstractListModel>
+#include <QList>
+#include <QIcon>
+
+#include "entities/historyelement.h"
+
+/**
+ * @class HistoryModel
+ *
+ * List model holding the history elements shown by the history view.
+ * History updates are applied as row insertions and removals so the view
+ * only lays out and paints the rows that actually changed.
+ */
+class HistoryModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    /// Custom roles of the history model
+    enum HistoryRole {
+        TypeRole = Qt::UserRole + 1,
+        TextRole,
+        DateRole,
+        UserNameRole,
+        SizeRole,
+        ProgressRole
+    };
+
+    /// Constructor
+    explicit HistoryModel(QObject *parent = 0);
+
+    /// See QAbstractListModel::rowCount()
+    int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    /// See QAbstractListModel::data()
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+
+    /**
+     * Replace the whole content of the model, used when the history is loaded
+     *
+     * @param history New history value
+     */
+    void setHistory(const QList<HistoryElement> &history);
+    /**
+     * Add an element on top of the model
+     *
+     * @param element New history element
+     */
+    void addElement(const HistoryElement &element);
+    /**
+     * Remove an element from the model
+     *
+     * @param row Row of the element
+     */
+    void removeElement(int row);
+    /**
+     * Remove all the elements from the model
+     */
+    void clear();
+    /**
+     * Update the download progress of an element
+     *
+     * @param element History element being downloaded
+     * @param progress Download progress percentage, 100 ends the download
+     * @return True if the progress bar of the row was shown or hidden
+     */
+    bool setProgress(const HistoryElement &element, unsigned progress);
+    /**
+     * Get the element of a row
+     *
+     * @param row Row of the element
+     * @return The element of the row
+     */
+    HistoryElement getElement(int row) const;
+
+    /**
+     * Find the proper icon depending on the file extension
+     *
+     * @param fileName Name of the file
+     * @return The proper icon
+     */
+    static QIcon getFileIcon(const QString &fileName);
+
+private:
+    /// Displayed elements
+    QList<HistoryElement> _history;
+    /// Download progress of each row, NO_PROGRESS if the row is not downloading
+    QList<int> _progress;
+
+    /**
+     * Insert an element in the model
+     *
+     * @param row Row of the element
+     * @param element Element to insert
+     */
+    void insertElement(int row, const HistoryElement &element);
+    /**
+     * Remove a range of elements from the model
+     *
+     * @param first First row to remove
+     * @param last Last row to remove
+     */
+    void removeElements(int first, int last);
+};
+
+#endif // HISTORYMODEL_H
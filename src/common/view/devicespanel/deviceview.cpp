@@ -75,7 +75,9 @@ DeviceView::~DeviceView()
 
 void DeviceView::loadStyle(const QString &color)
 {
-    QString css = FileHelper::loadFileContent(DEVICE_VIEW_CSS);
+    // The template is shared by all the devices, it is read once
+    static const QString cssTemplate = FileHelper::loadFileContent(DEVICE_VIEW_CSS);
+    QString css = cssTemplate;
 
     css.replace("#borderColor#", color);
 
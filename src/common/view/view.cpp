@@ -23,7 +23,6 @@
 #include "helpers/logmanager.h"
 #include "helpers/settingsmanager.h"
 #include "historyelement.h"
-#include "historyelementview.h"
 #include "appconfig.h"
 
 #include <QMessageBox>
@@ -139,6 +138,7 @@ void View::clearGrid()
     }
     clearCenterInfoWidget();
     _devices.clear();
+    _devicesByUid.clear();
 }
 
 void View::clearCenterInfoWidget()
@@ -220,43 +220,54 @@ void View::refreshEnded()
 void View::updateDevices()
 {
     QList<Device*> devices = _model->getSortedDevices();
-    QList<QPair<unsigned, unsigned> > positions = getPosition(devices.size());
-    unsigned count = 0;
-
-    clearGrid();
-    _widget->clearDevices();
+    QHash<QString, DeviceView*> removedDevices = _devicesByUid;
+    QList<DeviceView*> sortedDevices;
 
-    if (devices.size() != 0)
+    foreach(Device *device, devices)
     {
-        foreach(Device *device, devices)
+        DeviceView *deviceWidget = removedDevices.take(device->getUID());
+
+        if (!deviceWidget)
         {
-            QPair<unsigned, unsigned> currentPosition = positions.at(count++);
-            DeviceView *deviceWidget = new DeviceView(device->getName(), device->getUID(), device->getType(), device->isAvailable(), device->getLastTransfertState(), device->getProgress(), this);
-
-            connect(deviceWidget, SIGNAL(sendFileSignal(QString,const QList<QUrl>&, DataType)),
-                    this, SLOT(onSendFile(const QString&, const QList<QUrl>&, DataType)));
-            connect(deviceWidget, SIGNAL(sendTextSignal(const QString&, const QString&, DataType)),
-                    this, SLOT(onSendText(const QString&, const QString&, DataType)));
-            connect(deviceWidget, SIGNAL(cancelTransfert(const QString&)),
-                    this, SLOT(onCancelTransfert(const QString&)));
-
-            _devices.push_back(deviceWidget);
-            ui->gridLayout->addWidget(deviceWidget, currentPosition.first, currentPosition.second);
+            deviceWidget = createDeviceView(device);
+            _devicesByUid.insert(device->getUID(), deviceWidget);
         }
-        _widget->updateDevices(devices);
+        else if (deviceWidget->getDeviceName() != device->getName())
+            deviceWidget->setDeviceName(device->getName());
+
+        sortedDevices.append(deviceWidget);
+    }
+
+    foreach (DeviceView *deviceWidget, removedDevices)
+    {
+        _devicesByUid.remove(deviceWidget->getDeviceUID());
+        ui->gridLayout->removeWidget(deviceWidget);
+        delete deviceWidget;
+    }
+
+    // Added, removed or renamed devices change the positions
+    if (sortedDevices != _devices)
+    {
+        _devices = sortedDevices;
+        layoutDevices();
     }
+
+    _widget->updateDevices(devices);
+
+    if (devices.size() != 0)
+        clearCenterInfoWidget();
     else
     {
-        QPair<unsigned, unsigned> currentPosition = positions.at(0);
+        QPair<unsigned, unsigned> currentPosition = getPosition(0).at(0);
 
         if (_lastBonjourState == BONJOUR_SERVICE_OK)
         {
             if (!_infoWidget)
             {
                 _infoWidget = new CenterInfoWidget(this);
+                ui->gridLayout->addWidget(_infoWidget, currentPosition.first, currentPosition.second);
             }
             _infoWidget->setNoDeviceMode();
-            ui->gridLayout->addWidget(_infoWidget, currentPosition.first, currentPosition.second);
         }
         else
             displayBonjourServiceError();
@@ -267,6 +278,35 @@ void View::updateDevices()
     updateTrayIcon();
 }
 
+DeviceView* View::createDeviceView(Device *device)
+{
+    DeviceView *deviceWidget = new DeviceView(device->getName(), device->getUID(), device->getType(), device->isAvailable(), device->getLastTransfertState(), device->getProgress(), this);
+
+    connect(deviceWidget, SIGNAL(sendFileSignal(QString,const QList<QUrl>&, DataType)),
+            this, SLOT(onSendFile(const QString&, const QList<QUrl>&, DataType)));
+    connect(deviceWidget, SIGNAL(sendTextSignal(const QString&, const QString&, DataType)),
+            this, SLOT(onSendText(const QString&, const QString&, DataType)));
+    connect(deviceWidget, SIGNAL(cancelTransfert(const QString&)),
+            this, SLOT(onCancelTransfert(const QString&)));
+
+    return deviceWidget;
+}
+
+void View::layoutDevices()
+{
+    QList<QPair<unsigned, unsigned> > positions = getPosition(_devices.size());
+    unsigned count = 0;
+
+    foreach (DeviceView *deviceWidget, _devices)
+        ui->gridLayout->removeWidget(deviceWidget);
+
+    foreach (DeviceView *deviceWidget, _devices)
+    {
+        QPair<unsigned, unsigned> currentPosition = positions.at(count++);
+        ui->gridLayout->addWidget(deviceWidget, currentPosition.first, currentPosition.second);
+    }
+}
+
 void View::updateTrayIcon()
 {
     QIcon icon;
@@ -324,10 +364,10 @@ void View::displayBonjourServiceError()
 
     if (!_infoWidget) {
         _infoWidget = new CenterInfoWidget(this);
+        ui->gridLayout->addWidget(_infoWidget, currentPosition.first, currentPosition.second);
     }
 
     _infoWidget->setBonjourErrorMode(message);
-    ui->gridLayout->addWidget(_infoWidget, currentPosition.first, currentPosition.second);
 }
 
 void View::manageWidgetVisibility()
@@ -456,14 +496,7 @@ void View::onProgressUpdated(const QString &message, const QString &uid, unsigne
 
 DeviceView* View::getDeviceByUID(const QString& uid) const
 {
-    foreach (DeviceView *device, _devices)
-    {
-        if(device->getDeviceUID() == uid)
-        {
-            return device;
-        }
-    }
-    return NULL;
+    return _devicesByUid.value(uid, NULL);
 }
 
 void View::createTrayActions()
@@ -657,9 +690,9 @@ void View::onUpdateNeeded(const QString &version, const QString &note)
     _updateDialog.updateAndShow(version, note);
 }
 
-void View::onCancelIncomingTransfert()
+void View::onCancelIncomingTransfert(const HistoryElement &element)
 {
-    emit cancelIncomingTransfert();
+    emit cancelIncomingTransfert(element);
 }
 
 void View::focusInEvent(QFocusEvent *event)
@@ -673,6 +706,16 @@ void View::onHistoryChanged(const QList<HistoryElement> &history)
     ui->configPanel->getHistoryListWidget()->onHistoryChanged(history);
 }
 
+void View::onHistoryElementAdded(const HistoryElement &element)
+{
+    ui->configPanel->getHistoryListWidget()->onHistoryElementAdded(element);
+}
+
+void View::onHistoryElementRemoved(int row)
+{
+    ui->configPanel->getHistoryListWidget()->onHistoryElementRemoved(row);
+}
+
 void View::showTrayMessage(const QString &message)
 {
     int timerInterval = 1000;
@@ -710,7 +753,7 @@ void View::onReceivingText(const QString &text)
     if (!isVisible() || isMinimized())
         showTrayMessage(tr("Réception d'un texte : ") + text);
 }
-void View::historyElementProgressUpdated(unsigned progress)
+void View::historyElementProgressUpdated(const HistoryElement &element, unsigned progress)
 {
-    ui->configPanel->getHistoryListWidget()->historyElementProgressUpdated(progress);
+    ui->configPanel->getHistoryListWidget()->historyElementProgressUpdated(element, progress);
 }
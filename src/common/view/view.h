@@ -24,10 +24,10 @@
 #include <QMainWindow>
 #include <QGraphicsScene>
 #include <QList>
+#include <QHash>
 #include <QMenu>
 #include <QLabel>
 #include <QMovie>
-#include <QListWidgetItem>
 #include <QSystemTrayIcon>
 #include <QPropertyAnimation>
 #include <QParallelAnimationGroup>
@@ -36,7 +36,6 @@
 #include "widget.h"
 #include "settingswidget.h"
 #include "historyelement.h"
-#include "historyelementview.h"
 #include "aboutwidget.h"
 #include "centerinfowidget.h"
 #include "model.h"
@@ -89,6 +88,17 @@ public:
       * Clear the view
       */
     void clearGrid();
+    /**
+      * Create the graphical device of a device
+      *
+      * @param device Device to display
+      * @return The widget, not added to the grid yet
+      */
+    DeviceView* createDeviceView(Device *device);
+    /**
+      * Place the graphical devices in the grid, in the order of _devices
+      */
+    void layoutDevices();
     /**
       * Find a graphical device by its name
       *
@@ -176,8 +186,10 @@ signals:
     void cancelTransfert(const QString &uid);
     /**
       * Notify the controller for a incoming transfert interruption
+      *
+      * @param element History element of the transfert
       */
-    void cancelIncomingTransfert();
+    void cancelIncomingTransfert(const HistoryElement &element);
     /**
       * Notify the controller that the window is focused to ask for new records
       */
@@ -193,11 +205,12 @@ public slots:
      */
     void onHowToOver();
     /**
-     * SLOT : Download (on last history element) progress changed
+     * SLOT : Download progress of an history element changed
      *
+     * @param element History element being downloaded
      * @param progress Download progress percentage
      */
-    void historyElementProgressUpdated(unsigned progress);
+    void historyElementProgressUpdated(const HistoryElement &element, unsigned progress);
     /**
       * @overload close event to keep the program in the tray bar
       */
@@ -246,6 +259,8 @@ public slots:
     void onServiceError(ServiceErrorState error, bool isCritical);
     /**
       * update the devices on the view
+      * Only the added, removed and renamed devices are touched,
+      * the grid is laid out again only if the list changed
       */
     void updateDevices();
     /**
@@ -353,10 +368,22 @@ public slots:
     * @param history New history value
     */
     void onHistoryChanged(const QList<HistoryElement> &history);
+    /**
+    * SLOT : on history element added
+    * @param element New history element
+    */
+    void onHistoryElementAdded(const HistoryElement &element);
+    /**
+    * SLOT : on history element removed
+    * @param row Row of the removed element
+    */
+    void onHistoryElementRemoved(int row);
     /**
      * SLOT : On incoming transfert canceled by user
+     *
+     * @param element History element of the transfert
      */
-    void onCancelIncomingTransfert();
+    void onCancelIncomingTransfert(const HistoryElement &element);
     /**
      * SLOT : On display message requested from device
      *
@@ -376,6 +403,8 @@ private:
     Model *_model;
     /// Graphical device list
     QList<DeviceView*> _devices;
+    /// Graphical devices by uid
+    QHash<QString, DeviceView*> _devicesByUid;
     /// Tray icon
     QSystemTrayIcon *_trayIcon;
     /// Tray icon menu
@@ -77,7 +77,9 @@ void SmallDeviceView::updateWidgetStyle(QWidget *widget, const QString &cssClass
 
 void SmallDeviceView::loadStyle(const QString &opacity ,const QString &color)
 {
-    QString css = FileHelper::loadFileContent(SMALL_DEVICE_VIEW_CSS);
+    // The template is shared by all the small devices, it is read once
+    static const QString cssTemplate = FileHelper::loadFileContent(SMALL_DEVICE_VIEW_CSS);
+    QString css = cssTemplate;
 
     css.replace("#opacity#", opacity);
     css.replace("#color#", color);
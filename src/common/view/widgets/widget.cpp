@@ -136,6 +136,8 @@ void Widget::updateDevices(QList<Device*> devices)
         tmp = getDeviceByUID(device->getUID());
         if (tmp)
         {
+            if (tmp->getDeviceName() != device->getName())
+                tmp->setDeviceName(device->getName());
             alreadyDisplayed.append(tmp);
         }
     }
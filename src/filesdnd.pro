@@ -27,7 +27,7 @@ win32: QMAKE_CXXFLAGS += -W4 -DNOMINMAX
 unix: QMAKE_CXXFLAGS += -Wall
 
 # Tests
-include("$PWD/../../tests/tests.pri")
+include("$$PWD/../tests/tests.pri")
 INCLUDEPATH += "$$PWD/../tests/"
 
 # Zeroconf lib
@@ -30,8 +30,14 @@
 
 #include "controller.h"
 #include "settingsmanager.h"
+#include "logmanager.h"
+#include "tracemanager.h"
+#include "metricsmanager.h"
 #include "appconfig.h"
 #include "autotest.h"
+#ifdef RUN_BENCHMARK
+#include "benchmark.h"
+#endif
 #include "fdndapplication.h"
 
 int main(int argc, char *argv[])
@@ -45,6 +51,11 @@ int main(int argc, char *argv[])
         qDebug() << failures << " TESTS FAILED!";
 #endif
 
+#ifdef RUN_BENCHMARK
+    QCoreApplication benchmarkApp(argc, argv);
+
+    return Benchmark::run(benchmarkApp);
+#else
 #if defined(Q_OS_LINUX)
     QApplication::addLibraryPath("/user/lib/i386-linux-gnu/qt5");
 #endif
@@ -84,6 +95,9 @@ int main(int argc, char *argv[])
 #endif
 
     SettingsManager::loadSettingsFile();
+    LogManager::start();
+    TraceManager::start();
+    MetricsManager::start();
     Controller controller;
     QApplication::setOrganizationName("Files Drag & Drop");
 
@@ -93,4 +107,5 @@ int main(int argc, char *argv[])
     controller.startView(&app);
 
     return app.exec();
+#endif
 }
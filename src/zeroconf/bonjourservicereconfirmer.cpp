@@ -29,7 +29,7 @@ void BonjourServiceReconfirmer::reconfirmBonjourRecord (const BonjourRecord &rec
     char *fullname = getFullName(record);
 
     cleanupResolve();
-    LogManager::appendLine("[BonjourReconfirmer] Try reconfirm device");
+    DEBUG_LOG(LOG_DISCOVERY, "[BonjourReconfirmer] Try reconfirm device");
     DNSServiceErrorType err = DNSServiceQueryRecord(&dnssref, kDNSServiceFlagsForce
                                                     ,0 , fullname, kDNSServiceType_PTR & kDNSServiceType_SRV,
                                                     kDNSServiceClass_IN, (DNSServiceQueryRecordReply) bonjourConfirmReply, this);
@@ -43,7 +43,7 @@ void BonjourServiceReconfirmer::reconfirmBonjourRecord (const BonjourRecord &rec
 
 void BonjourServiceReconfirmer::bonjourConfirmReply(DNSServiceRef , const DNSServiceFlags , uint32_t ifIndex, DNSServiceErrorType , const char *fullname, uint16_t rrtype, uint16_t rrclass, uint16_t rdlen, const void *rdata, uint32_t , void *)
 {
-    LogManager::appendLine("[BonjourReconfirmer] Device reconfirmed");
+    DEBUG_LOG(LOG_DISCOVERY, "[BonjourReconfirmer] Device reconfirmed");
     DNSServiceReconfirmRecord(kDNSServiceFlagsForce, ifIndex, fullname, rrtype, rrclass, rdlen, rdata);
 }
 
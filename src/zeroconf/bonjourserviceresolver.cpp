@@ -33,6 +33,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "bonjourrecord.h"
 #include "bonjourserviceresolver.h"
 #include "../helpers/settingsmanager.h"
+#include "../helpers/metricsmanager.h"
 
 BonjourServiceResolver::BonjourServiceResolver(QObject *parent)
     : QObject(parent), dnssref(0), bonjourSocket(0), _bonjourPort(-1)
@@ -68,7 +69,8 @@ void BonjourServiceResolver::resolveBonjourRecord(const BonjourRecord &record)
 
     _currentBonjourRecord = record;
     _timeout.start(BONJOUR_TIMEOUT);
-    LogManager::appendLine(QString("[BonjourResolver] Start resolve on : ").append(record.serviceName));
+    _latency.start();
+    DEBUG_LOG(LOG_DISCOVERY, QString("[BonjourResolver] Start resolve on : ").append(record.serviceName));
 
     DNSServiceErrorType err = DNSServiceResolve(&dnssref, 0, 0,
                                                 record.serviceName.toUtf8().constData(),
@@ -122,28 +124,27 @@ void BonjourServiceResolver::bonjourResolveReply(DNSServiceRef, DNSServiceFlags
 
 void BonjourServiceResolver::finishConnect(const QHostInfo &hostInfo)
 {
-    Device *device = parseDevice(_fullName, hostInfo, _bonjourPort);
-    if (device)
+    DeviceRecord record;
+
+    MetricsManager::observe(METRIC_RESOLVER_LATENCY, _latency.nsecsElapsed() / 1e9);
+    if (parseDevice(_fullName, hostInfo, _bonjourPort, record))
     {
-        device->setBonjourRecord(_currentBonjourRecord);
-        device->setDetectedBy(DETECTED_BY_BONJOUR);
-        emit bonjourRecordResolved(device);
+        record._bonjourRecord = _currentBonjourRecord;
+        record._detectedBy = DETECTED_BY_BONJOUR;
+        emit bonjourRecordResolved(record);
     }
     QMetaObject::invokeMethod(this, "cleanupResolve", Qt::QueuedConnection);
 }
 
-Device* BonjourServiceResolver::parseDevice(QString name, const QHostInfo &hostInfo, int bonjourPort)
+bool BonjourServiceResolver::parseDevice(QString name, const QHostInfo &hostInfo, int bonjourPort, DeviceRecord &record)
 {
-    QString uid, stype, version;
-
-    uid = _txtRecordParsed.value("uid");
-    stype = _txtRecordParsed.value("type");
-    version = _txtRecordParsed.value("version");
-
-    Device *device = NULL;
-
-    if (uid != SettingsManager::getDeviceUID())
-        device = new Device(name, stype, uid, hostInfo, bonjourPort, version);
-
-    return device;
+    record._name = name;
+    record._uid = _txtRecordParsed.value("uid");
+    record._type = _txtRecordParsed.value("type");
+    record._version = _txtRecordParsed.value("version");
+    record._hostInfo = hostInfo;
+    record._port = bonjourPort;
+    record._features = _txtRecordParsed.value(KEY_FEATURES).toUInt();
+
+    return (record._uid != SettingsManager::getDeviceUID());
 }
@@ -30,9 +30,11 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define BONJOURSERVICERESOLVER_H
 
 #include <QtCore/QObject>
+#include <QtCore/QElapsedTimer>
 #include <bonjour/dns_sd.h>
 #include "../config/appconfig.h"
 #include "../entities/device.h"
+#include "../entities/devicerecord.h"
 #include "bonjourservicereconfirmer.h"
 #include "../entities/txtrecord.h"
 
@@ -48,9 +50,9 @@ public:
     ~BonjourServiceResolver();
 
     void resolveBonjourRecord(const BonjourRecord &record);
-    Device* parseDevice(QString _fullName, const QHostInfo &hostInfo, int _bonjourPort);
+    bool parseDevice(QString _fullName, const QHostInfo &hostInfo, int _bonjourPort, DeviceRecord &record);
 signals:
-    void bonjourRecordResolved(Device *device);
+    void bonjourRecordResolved(const DeviceRecord &record);
     void error(DNSServiceErrorType error);
     void finish(BonjourServiceResolver*);
 
@@ -71,6 +73,7 @@ private:
     QMap<QString,QString> _txtRecordParsed;
     BonjourRecord _currentBonjourRecord;
     QTimer _timeout;
+    QElapsedTimer _latency;
     int sockfd;
 };
 
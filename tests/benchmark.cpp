@@ -0,0 +1,464 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#include "benchmark.h"
+#include "entities/service.h"
+#include "helpers/settingsmanager.h"
+#include "threads/deviceconnectionthreadevent.h"
+#include "config/appconfig.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QUrl>
+#include <QHostInfo>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QTextStream>
+#include <QStringList>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+/**
+  * Drop the Qt messages, the standard output is kept for the results
+  */
+static void discardMessage(QtMsgType, const QMessageLogContext &, const QString &)
+{
+}
+
+/**
+  * Write an error of the benchmark on the standard error
+  */
+static void printError(const QString &message)
+{
+    QTextStream(stderr) << "[Benchmark] " << message << endl;
+}
+
+Benchmark::Benchmark(const QCommandLineParser &parser) :
+    _parser(parser),
+    _discovery(this),
+    _service(0),
+    _device(0),
+    _cpuStart(0),
+    _timeout(this),
+    _transferRunning(false),
+    _datasetFailed(false),
+    _failed(false)
+{
+    _timeout.setSingleShot(true);
+    _timeout.setInterval(BENCHMARK_TIMEOUT);
+    connect(&_timeout, SIGNAL(timeout()), this, SLOT(onTimeout()));
+}
+
+Benchmark::~Benchmark()
+{
+    delete _device;
+    _serviceThread.quit();
+    _serviceThread.wait();
+    delete _service;
+}
+
+int Benchmark::run(QCoreApplication &app)
+{
+    QCommandLineParser parser;
+
+    parser.setApplicationDescription("Loopback transfer benchmark, the results are written as JSON");
+    parser.addHelpOption();
+    parser.addOption(QCommandLineOption("output", "Write the results to <file> instead of the standard output.", "file"));
+    parser.addOption(QCommandLineOption("datasets", "Datasets to send, among text, tiny, tree and huge.", "names", "text,tiny,tree,huge"));
+    parser.addOption(QCommandLineOption("text-count", "Number of texts and urls of the text dataset.", "count", "1000"));
+    parser.addOption(QCommandLineOption("tiny-count", "Number of files of the tiny dataset.", "count", "5000"));
+    parser.addOption(QCommandLineOption("tree-depth", "Depth of the folder of the tree dataset.", "depth", "64"));
+    parser.addOption(QCommandLineOption("huge-size", "Size of the file of the huge dataset, in MiB.", "size", "1024"));
+    parser.addOption(QCommandLineOption("features", "Protocol features offered by the device.", "mask", QString::number(PROTOCOL_FEATURES)));
+    parser.addOption(QCommandLineOption("verbose", "Show the Qt messages."));
+    parser.process(app);
+
+    if (!parser.isSet("verbose"))
+        qInstallMessageHandler(discardMessage);
+
+    // The settings, the history and the log of the user are left untouched
+    SettingsManager::setReadOnly(true);
+    SettingsManager::setLogEnabled(false);
+    SettingsManager::setAutoOpenFiles(false);
+
+    Benchmark benchmark(parser);
+
+    QMetaObject::invokeMethod(&benchmark, "start", Qt::QueuedConnection);
+
+    return app.exec();
+}
+
+void Benchmark::start()
+{
+    quint16 port = 0;
+    QHostInfo info;
+
+    if (!_workDir.isValid() || !createDatasets())
+    {
+        printError("Can't create the datasets");
+        QCoreApplication::exit(1);
+        return;
+    }
+
+    _receiveFolder = _workDir.path() + "/received";
+    SettingsManager::setDestinationFolder(_receiveFolder);
+
+    _service = new Service(&_discovery, 0, _workDir.path() + "/" + HISTORY_FILE);
+    _service->moveToThread(&_serviceThread);
+    _serviceThread.start();
+    QMetaObject::invokeMethod(_service, "listenOnLoopback", Qt::BlockingQueuedConnection, Q_RETURN_ARG(quint16, port));
+
+    if (port == 0)
+    {
+        printError("Can't start the service");
+        QCoreApplication::exit(1);
+        return;
+    }
+
+    info.setAddresses(QList<QHostAddress>() << QHostAddress(QHostAddress::LocalHost));
+    _device = new Device("Benchmark", SettingsManager::getType(), BENCHMARK_DEVICE_UID, info, port, PROTOCOL_VERSION);
+    _device->setFeatures(_parser.value("features").toUInt());
+    connect(_device, SIGNAL(deviceAvailable(QString,TransfertState)), this, SLOT(onDeviceAvailable(QString,TransfertState)));
+
+    startNextDataset();
+}
+
+bool Benchmark::createDatasets()
+{
+    QString datasetsFolder = _workDir.path() + "/datasets";
+    quint64 seed = 1;
+
+    foreach (const QString &name, _parser.value("datasets").split(",", QString::SkipEmptyParts))
+    {
+        BenchmarkDataset dataset;
+        DataStruct data;
+
+        dataset.name = name;
+        dataset.files = 0;
+        dataset.bytes = 0;
+        dataset.written = true;
+        data._type = TYPE_FILE_SAVE;
+
+        if (name == "text")
+        {
+            // A burst of transfers, each of them a single text or url
+            dataset.files = _parser.value("text-count").toInt();
+            dataset.written = false;
+            for (int i = 0; i < dataset.files; ++i)
+            {
+                if (i % 2 == 0)
+                {
+                    data._type = TYPE_TEXT;
+                    data._string = "Benchmark text " + QString::number(i) + " " + QString(64, 'x');
+                }
+                else
+                {
+                    data._type = TYPE_URL_OPEN;
+                    data._string = "https://example.com/benchmark/" + QString::number(i);
+                }
+                dataset.bytes += data._string.toUtf8().size();
+                dataset.transfers.append(data);
+            }
+        }
+        else if (name == "tiny")
+        {
+            QString folder = datasetsFolder + "/tiny";
+
+            // A single transfer of many files
+            dataset.files = _parser.value("tiny-count").toInt();
+            dataset.bytes = (qint64)dataset.files * BENCHMARK_TINY_FILE_SIZE;
+            QDir().mkpath(folder);
+            for (int i = 0; i < dataset.files; ++i)
+            {
+                QString path = folder + QString("/tiny-%1.bin").arg(i, 6, 10, QChar('0'));
+
+                if (!writeFile(path, BENCHMARK_TINY_FILE_SIZE, seed++))
+                    return false;
+                data._urls.append(QUrl::fromLocalFile(path));
+            }
+            dataset.transfers.append(data);
+        }
+        else if (name == "tree")
+        {
+            QString folder = datasetsFolder + "/tree";
+            int depth = _parser.value("tree-depth").toInt();
+
+            // A single folder, each level holds a few files and the next level
+            dataset.files = depth * BENCHMARK_TREE_FILES_PER_LEVEL;
+            dataset.bytes = (qint64)dataset.files * BENCHMARK_TREE_FILE_SIZE;
+            data._urls.append(QUrl::fromLocalFile(folder));
+            for (int level = 0; level < depth; ++level)
+            {
+                folder += "/level-" + QString::number(level);
+                QDir().mkpath(folder);
+                for (int i = 0; i < BENCHMARK_TREE_FILES_PER_LEVEL; ++i)
+                {
+                    if (!writeFile(folder + "/file-" + QString::number(i) + ".bin", BENCHMARK_TREE_FILE_SIZE, seed++))
+                        return false;
+                }
+            }
+            dataset.transfers.append(data);
+        }
+        else if (name == "huge")
+        {
+            QString path = datasetsFolder + "/huge.bin";
+
+            dataset.files = 1;
+            dataset.bytes = _parser.value("huge-size").toLongLong() * 1024 * 1024;
+            QDir().mkpath(datasetsFolder);
+            if (!writeFile(path, dataset.bytes, seed++))
+                return false;
+            data._urls.append(QUrl::fromLocalFile(path));
+            dataset.transfers.append(data);
+        }
+        else
+        {
+            printError("Unknown dataset " + name);
+            return false;
+        }
+
+        _datasets.append(dataset);
+    }
+
+    return true;
+}
+
+void Benchmark::startNextDataset()
+{
+    if (_datasets.isEmpty())
+    {
+        writeResults();
+        QCoreApplication::exit(_failed ? 1 : 0);
+        return;
+    }
+
+    // Each dataset is received in an empty folder, so that it can be checked
+    QDir(_receiveFolder).removeRecursively();
+    QDir().mkpath(_receiveFolder);
+
+    _transfers = _datasets.first().transfers;
+    _datasetFailed = false;
+    _cpuStart = getCpuTime();
+    _clock.start();
+    _timeout.start();
+    continueDataset();
+}
+
+void Benchmark::startNextTransfer()
+{
+    _transferRunning = true;
+    _device->setDataStruct(_transfers.takeFirst());
+    _device->tryConnect();
+    QCoreApplication::postEvent(_device, new DeviceConnectionThreadEvent());
+}
+
+void Benchmark::onDeviceAvailable(const QString &, TransfertState state)
+{
+    if (!_transferRunning)
+        return;
+
+    _transferRunning = false;
+    if (state != SUCCESS)
+        _datasetFailed = true;
+
+    // The device is still in the middle of its transfer end
+    QMetaObject::invokeMethod(this, "continueDataset", Qt::QueuedConnection);
+}
+
+void Benchmark::onTimeout()
+{
+    printError("Dataset " + _datasets.first().name + " timed out");
+    _transfers.clear();
+    _device->cancelTransfert();
+}
+
+void Benchmark::continueDataset()
+{
+    if (!_datasetFailed && !_transfers.isEmpty())
+        startNextTransfer();
+    else
+        finishDataset();
+}
+
+void Benchmark::finishDataset()
+{
+    double seconds = _clock.nsecsElapsed() / 1e9;
+    double cpuSeconds = getCpuTime() - _cpuStart;
+    BenchmarkDataset dataset = _datasets.takeFirst();
+    bool succeeded = !_datasetFailed;
+    QJsonObject result;
+
+    _timeout.stop();
+
+    // The files must have been received entirely
+    if (succeeded && dataset.written && getFolderSize(_receiveFolder) != dataset.bytes)
+    {
+        printError("Dataset " + dataset.name + " received incompletely");
+        succeeded = false;
+    }
+    if (!succeeded)
+        _failed = true;
+
+    result.insert("dataset", dataset.name);
+    result.insert("succeeded", succeeded);
+    result.insert("files", dataset.files);
+    result.insert("bytes", (double)dataset.bytes);
+    result.insert("seconds", seconds);
+    result.insert("mbPerSecond", seconds > 0 ? dataset.bytes / 1e6 / seconds : 0);
+    result.insert("filesPerSecond", seconds > 0 ? dataset.files / seconds : 0);
+    result.insert("cpuSeconds", cpuSeconds);
+    _results.append(result);
+
+    startNextDataset();
+}
+
+void Benchmark::writeResults()
+{
+    QJsonObject report;
+    QFile output;
+
+    report.insert("benchmark", QString("loopback"));
+    report.insert("protocolVersion", QString(PROTOCOL_VERSION));
+    report.insert("features", (int)_parser.value("features").toUInt());
+    report.insert("qtVersion", QString(qVersion()));
+    // High-water mark of the whole process, it cannot be split by dataset
+    report.insert("peakRssBytes", (double)getPeakRss());
+    report.insert("results", _results);
+
+    if (_parser.isSet("output"))
+    {
+        output.setFileName(_parser.value("output"));
+        if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            printError("Can't write " + output.fileName());
+            _failed = true;
+            return;
+        }
+    }
+    else
+        output.open(stdout, QIODevice::WriteOnly);
+
+    output.write(QJsonDocument(report).toJson());
+    output.close();
+}
+
+bool Benchmark::writeFile(const QString &path, qint64 size, quint64 seed)
+{
+    QFile file(path);
+    QByteArray buffer(qMin(size, (qint64)BENCHMARK_BUFFER_SIZE), 0);
+    quint64 state = seed * 0x9E3779B97F4A7C15ULL;
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    while (size > 0)
+    {
+        qint64 chunk = qMin(size, (qint64)buffer.size());
+
+        // Xorshift, incompressible and the same from one run to another
+        for (qint64 i = 0; i < chunk; ++i)
+        {
+            if (i % sizeof(state) == 0)
+            {
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+            }
+            buffer[(int)i] = (char)(state >> (8 * (i % sizeof(state))));
+        }
+
+        if (file.write(buffer.constData(), chunk) != chunk)
+            return false;
+        size -= chunk;
+    }
+
+    return true;
+}
+
+qint64 Benchmark::getFolderSize(const QString &path)
+{
+    QDirIterator it(path, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+    qint64 size = 0;
+
+    while (it.hasNext())
+    {
+        it.next();
+        size += it.fileInfo().size();
+    }
+
+    return size;
+}
+
+double Benchmark::getCpuTime()
+{
+#if defined(Q_OS_WIN)
+    FILETIME creation, exit, kernel, user;
+    ULARGE_INTEGER kernelTime, userTime;
+
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+        return 0;
+
+    kernelTime.LowPart = kernel.dwLowDateTime;
+    kernelTime.HighPart = kernel.dwHighDateTime;
+    userTime.LowPart = user.dwLowDateTime;
+    userTime.HighPart = user.dwHighDateTime;
+
+    // 100 ns units
+    return (kernelTime.QuadPart + userTime.QuadPart) / 1e7;
+#else
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec
+            + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+#endif
+}
+
+qint64 Benchmark::getPeakRss()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+
+    return counters.PeakWorkingSetSize;
+#else
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+
+#if defined(Q_OS_OSX)
+    // Bytes on OS X, kilobytes elsewhere
+    return usage.ru_maxrss;
+#else
+    return (qint64)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
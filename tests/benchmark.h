@@ -0,0 +1,202 @@
+/**************************************************************************************
+**
+** Copyright (C) 2014 Files Drag & Drop
+**
+** This library is free software; you can redistribute it and/or
+** modify it under the terms of the GNU Lesser General Public
+** License as published by the Free Software Foundation; either
+** version 2.1 of the License, or (at your option) any later version.
+**
+** This library is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+** Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public
+** License along with this library; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+**************************************************************************************/
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QObject>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QTimer>
+#include <QList>
+
+#include "entities/datastruct.h"
+#include "entities/device.h"
+#include "udp/udpdiscovery.h"
+#include "threads/servicethread.h"
+
+class Service;
+
+#define BENCHMARK_DEVICE_UID "benchmark"
+#define BENCHMARK_TIMEOUT (30 * 60 * 1000) // ms, for a whole dataset
+#define BENCHMARK_BUFFER_SIZE (1024 * 1024)
+#define BENCHMARK_TINY_FILE_SIZE 1024
+#define BENCHMARK_TREE_FILE_SIZE (16 * 1024)
+#define BENCHMARK_TREE_FILES_PER_LEVEL 4
+
+/**
+  * @struct BenchmarkDataset
+  *
+  * Synthetic dataset, sent as a sequence of transfers
+  */
+struct BenchmarkDataset
+{
+    /// Name of the dataset
+    QString name;
+    /// Transfers of the dataset, in order
+    QList<DataStruct> transfers;
+    /// Number of files, each text or url counts as a file
+    int files;
+    /// Bytes of payload
+    qint64 bytes;
+    /// True if the received files must add up to bytes
+    bool written;
+};
+
+/**
+  * @class Benchmark
+  *
+  * Headless loopback benchmark : a Service and a Device talk over 127.0.0.1 in one process
+  * Each dataset is timed separately, the results are written as JSON
+  */
+class Benchmark : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+      * Constructor
+      *
+      * @param parser Parsed command line of the benchmark
+      */
+    Benchmark(const QCommandLineParser &parser);
+    /**
+      * Destructor, stops the service thread
+      */
+    ~Benchmark();
+
+    /**
+      * Parse the command line, run the benchmark and write its results
+      *
+      * @param app Application running the benchmark
+      * @return 0 if every dataset has been transferred, 1 otherwise
+      */
+    static int run(QCoreApplication &app);
+
+private slots:
+    /**
+      * Generate the datasets and start the service, then the first dataset
+      */
+    void start();
+    /**
+      * The device finished a transfer
+      *
+      * @param uid Uid of the device
+      * @param state Result of the transfer
+      */
+    void onDeviceAvailable(const QString &uid, TransfertState state);
+    /**
+      * The current dataset took too long
+      */
+    void onTimeout();
+    /**
+      * Send the next transfer, or finish the dataset once it is done or failed
+      */
+    void continueDataset();
+
+private:
+    /// Command line of the benchmark
+    const QCommandLineParser &_parser;
+    /// Folder of the datasets, the received files and the history
+    QTemporaryDir _workDir;
+    /// Folder receiving the files
+    QString _receiveFolder;
+    /// Udp discovery module required by the service, nothing is announced
+    UdpDiscovery _discovery;
+    /// Receiving side
+    Service *_service;
+    /// Thread of the service, as in the application
+    ServiceThread _serviceThread;
+    /// Sending side
+    Device *_device;
+    /// Datasets not sent yet
+    QList<BenchmarkDataset> _datasets;
+    /// Transfers of the current dataset not sent yet
+    QList<DataStruct> _transfers;
+    /// Wall clock of the current dataset
+    QElapsedTimer _clock;
+    /// CPU time of the process when the current dataset started, in seconds
+    double _cpuStart;
+    /// Timeout of the current dataset
+    QTimer _timeout;
+    /// Results of the finished datasets
+    QJsonArray _results;
+    /// True while the device sends a transfer
+    bool _transferRunning;
+    /// True if a transfer of the current dataset failed
+    bool _datasetFailed;
+    /// True if a dataset failed
+    bool _failed;
+
+    /**
+      * Generate the requested datasets in the work folder
+      *
+      * @return False if a dataset could not be written
+      */
+    bool createDatasets();
+    /**
+      * Send the next dataset, or write the results if there is none left
+      */
+    void startNextDataset();
+    /**
+      * Send the next transfer of the current dataset
+      */
+    void startNextTransfer();
+    /**
+      * Record the result of the current dataset and go on with the next one
+      */
+    void finishDataset();
+    /**
+      * Write the results to the output file, or to the standard output
+      */
+    void writeResults();
+    /**
+      * Write a file of pseudo-random content, the same from one run to another
+      *
+      * @param path Path of the file
+      * @param size Size of the file
+      * @param seed Seed of the content, different for each file so that archives do not compress
+      * @return False if the file could not be written
+      */
+    static bool writeFile(const QString &path, qint64 size, quint64 seed);
+    /**
+      * Get the size of the files of a folder and of its subfolders
+      *
+      * @param path Path of the folder
+      * @return The total size
+      */
+    static qint64 getFolderSize(const QString &path);
+    /**
+      * Get the CPU time used by the process, all threads included
+      *
+      * @return User and system time, in seconds
+      */
+    static double getCpuTime();
+    /**
+      * Get the peak resident memory of the process since it started
+      *
+      * @return The peak, in bytes
+      */
+    static qint64 getPeakRss();
+};
+
+#endif // BENCHMARK_H
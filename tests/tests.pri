@@ -1,11 +1,23 @@
-SOURCES += \
+HEADERS += \
     $$PWD/../tests/autotest.h \
     $$PWD/../tests/modeltest.h
 
-HEADERS += \
+SOURCES += \
     $$PWD/../tests/modeltest.cpp
 
 CONFIG(debug) {
     #QT += testlib
     #QMAKE_CXXFLAGS += -DVERBOSE -DRUN_TESTS
 }
+
+# Headless loopback benchmark : qmake CONFIG+=benchmark
+benchmark {
+    TARGET = filesdnd-benchmark
+    CONFIG += console
+    CONFIG -= app_bundle
+    DEFINES += RUN_BENCHMARK
+    win32: LIBS += Psapi.lib
+
+    HEADERS += $$PWD/../tests/benchmark.h
+    SOURCES += $$PWD/../tests/benchmark.cpp
+}